@@ -0,0 +1,291 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "headers/constants.h"
+#include "headers/context.h"
+#include "headers/arena.h"
+
+
+/*Description: this file contains the arena of a file, which the assembler allocates the short lived strings of a
+  file from (tokens, operands, label and instruction names) instead of calling malloc for each of them. Memory is
+  taken from large blocks and never freed one allocation at a time: the pre processor and the first pass mark the
+  arena before a line or a statement and release everything allocated after the mark once it is handled, and the
+  whole arena is reset when the context is reset for the next file, or freed with the context.
+  Names that must live until the end of the file (labels, entries, the name of the macro being declared) are interned:
+  every distinct name is stored once, in blocks of its own that are not released by arenaRelease.*/
+
+
+typedef struct Arena_Block{
+    struct Arena_Block* next;
+    size_t size; /*size of the memory of the block, which follows the block itself*/
+    size_t used;
+} Arena_Block;
+
+
+/*Blocks that are allocated from in order. The blocks after current are empty and are reused before new ones
+  are allocated.*/
+typedef struct Block_Chain{
+    Arena_Block* first;
+    Arena_Block* current;
+} Block_Chain;
+
+
+typedef struct Interned_String{
+    unsigned long hash;
+    char* text; /*NULL marks an empty slot*/
+} Interned_String;
+
+
+/*Counters of the allocations of an arena, added to the counters of the run when the arena is reset or freed.*/
+typedef struct Allocation_Stats{
+    long allocations; /*allocations served by the arena, each of them used to be a malloc*/
+    long bytes;
+    long blocks; /*blocks allocated with malloc*/
+    long internedStrings; /*distinct names stored by internString*/
+    long internedLookups; /*calls to internString*/
+} Allocation_Stats;
+
+
+typedef struct Arena{
+    Block_Chain scratch; /*released by arenaRelease*/
+    Block_Chain strings; /*interned strings, kept until the arena is reset*/
+    Interned_String* slots; /*open addressing hash table (linear probing) of the interned strings*/
+    int slotCount; /*always a power of two*/
+    int stringCount;
+    Allocation_Stats stats;
+} Arena;
+
+
+static Allocation_Stats totalStats; /*counters of every arena of the run*/
+static pthread_mutex_t totalStatsLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*Allocates a block with room for at least size bytes.*/
+static Arena_Block* createBlock(Arena* arena, size_t size){
+    Arena_Block* block;
+    if (size < ARENA_BLOCK_SIZE)
+        size = ARENA_BLOCK_SIZE;
+    block = malloc(sizeof(Arena_Block) + size);
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    arena->stats.blocks++;
+    return block;
+}
+
+
+/*Returns size rounded up so that every allocation is aligned for any type.*/
+static size_t alignSize(size_t size){
+    size_t alignment = sizeof(union {long l; double d; void* p;});
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+
+/*Allocates size bytes from a chain of blocks, moving on to the next empty block (or a new one) if the current block
+  does not have room.*/
+static void* allocateFromChain(Arena* arena, Block_Chain* chain, size_t size){
+    Arena_Block* block = chain->current;
+    void* memory;
+
+    size = alignSize(size);
+    if (block->used + size > block->size){
+        if (block->next == NULL || block->next->size < size){
+            /*a new block is put before the empty ones so that they are still reused*/
+            Arena_Block* newBlock = createBlock(arena, size);
+            newBlock->next = block->next;
+            block->next = newBlock;
+        }
+        block = chain->current = block->next;
+        block->used = 0;
+    }
+    memory = (char*)(block + 1) + block->used;
+    block->used += size;
+    arena->stats.allocations++;
+    arena->stats.bytes += size;
+    return memory;
+}
+
+
+/*Empties a chain of blocks and frees all of its blocks but the first.*/
+static void resetChain(Block_Chain* chain){
+    Arena_Block* block = chain->first->next;
+    Arena_Block* next;
+    while (block != NULL){
+        next = block->next;
+        free(block);
+        block = next;
+    }
+    chain->first->next = NULL;
+    chain->first->used = 0;
+    chain->current = chain->first;
+}
+
+
+/*Adds the counters of an arena to the counters of the run and clears them.*/
+static void flushArenaStats(Arena* arena){
+    pthread_mutex_lock(&totalStatsLock);
+    totalStats.allocations += arena->stats.allocations;
+    totalStats.bytes += arena->stats.bytes;
+    totalStats.blocks += arena->stats.blocks;
+    totalStats.internedStrings += arena->stats.internedStrings;
+    totalStats.internedLookups += arena->stats.internedLookups;
+    pthread_mutex_unlock(&totalStatsLock);
+    memset(&arena->stats, 0, sizeof(Allocation_Stats));
+}
+
+
+/*Creates an empty arena (must be freed with freeArena).*/
+Arena* createArena(){
+    Arena* arena = calloc(1, sizeof(Arena));
+    arena->scratch.first = arena->scratch.current = createBlock(arena, ARENA_BLOCK_SIZE);
+    arena->strings.first = arena->strings.current = createBlock(arena, ARENA_BLOCK_SIZE);
+    arena->slotCount = INTERNED_STRINGS_INITIAL_SLOTS;
+    arena->slots = calloc(arena->slotCount, sizeof(Interned_String));
+    return arena;
+}
+
+
+/*Releases everything allocated from an arena, including the interned strings, so that it can be used for the next
+  file. Only the first block of each chain is kept.*/
+void resetArena(Arena* arena){
+    resetChain(&arena->scratch);
+    resetChain(&arena->strings);
+    memset(arena->slots, 0, arena->slotCount * sizeof(Interned_String));
+    arena->stringCount = 0;
+    flushArenaStats(arena);
+}
+
+
+/*Frees an arena and everything allocated from it.*/
+void freeArena(Arena* arena){
+    resetArena(arena);
+    free(arena->scratch.first);
+    free(arena->strings.first);
+    free(arena->slots);
+    free(arena);
+}
+
+
+/*Returns the arena of the current context.*/
+static Arena* getArena(){
+    return getCurrentContext()->arena;
+}
+
+
+/*Allocates size bytes of scratch memory from the arena of the current context. The memory is not initialized and
+  is valid until the arena is released to a mark taken before the allocation, or reset.*/
+void* arenaAlloc(size_t size){
+    Arena* arena = getArena();
+    return allocateFromChain(arena, &arena->scratch, size);
+}
+
+
+/*Like arenaAlloc, for count elements of the given size that are set to zero.*/
+void* arenaCalloc(size_t count, size_t size){
+    void* memory = arenaAlloc(count * size);
+    memset(memory, 0, count * size);
+    return memory;
+}
+
+
+/*Returns a terminated copy of text of the given length in scratch memory.*/
+char* arenaCopy(const char* text, size_t length){
+    char* copy = arenaAlloc(length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+
+/*Returns the FNV-1a hash of a string.*/
+static unsigned long hashString(const char* text){
+    unsigned long hash = 2166136261UL;
+    while (*text){
+        hash = ((hash ^ (unsigned char)*text) * 16777619UL) & 0xffffffffUL;
+        text++;
+    }
+    return hash;
+}
+
+
+/*Doubles the number of slots of the interned strings and enters all strings into the new slots.*/
+static void growInternedStrings(Arena* arena){
+    Interned_String* oldSlots = arena->slots;
+    int oldSlotCount = arena->slotCount;
+    unsigned long mask, j;
+    int i;
+
+    arena->slotCount *= 2;
+    arena->slots = calloc(arena->slotCount, sizeof(Interned_String));
+    mask = arena->slotCount - 1;
+    for (i=0; i < oldSlotCount; i++){
+        if (oldSlots[i].text == NULL)
+            continue;
+        for (j = oldSlots[i].hash & mask; arena->slots[j].text != NULL; j = (j + 1) & mask)
+            ;
+        arena->slots[j] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+
+/*Returns the interned copy of text: every distinct string is stored once in the arena of the current context, and
+  equal strings return the same copy. The copy must not be changed and is valid until the arena is reset.*/
+char* internString(const char* text){
+    Arena* arena = getArena();
+    unsigned long hash = hashString(text);
+    unsigned long mask, i;
+    size_t length;
+
+    arena->stats.internedLookups++;
+    if ((arena->stringCount + 1) * 2 > arena->slotCount)
+        growInternedStrings(arena);
+    mask = arena->slotCount - 1;
+    for (i = hash & mask; arena->slots[i].text != NULL; i = (i + 1) & mask){
+        if (arena->slots[i].hash == hash && strcmp(arena->slots[i].text, text) == 0)
+            return arena->slots[i].text;
+    }
+
+    length = strlen(text);
+    arena->slots[i].hash = hash;
+    arena->slots[i].text = allocateFromChain(arena, &arena->strings, length + 1);
+    memcpy(arena->slots[i].text, text, length + 1);
+    arena->stringCount++;
+    arena->stats.internedStrings++;
+    return arena->slots[i].text;
+}
+
+
+/*Returns the current position in the scratch memory of the arena of the current context.*/
+Arena_Mark arenaMark(){
+    Arena_Mark mark;
+    Arena* arena = getArena();
+    mark.block = arena->scratch.current;
+    mark.used = arena->scratch.current->used;
+    return mark;
+}
+
+
+/*Releases all scratch memory allocated since mark was taken. The blocks after the mark are kept for reuse.*/
+void arenaRelease(Arena_Mark mark){
+    Arena* arena = getArena();
+    arena->scratch.current = mark.block;
+    mark.block->used = mark.used;
+}
+
+
+/*Prints the counters of the arenas of every file assembled so far and the peak memory of the process.*/
+void printAllocationStats(FILE* stream){
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    pthread_mutex_lock(&totalStatsLock);
+    fprintf(stream, "Allocations: %ld from arenas (%ld bytes) in %ld malloc'd blocks, %ld names interned out of %ld lookups.\n",
+        totalStats.allocations, totalStats.bytes, totalStats.blocks, totalStats.internedStrings, totalStats.internedLookups);
+    pthread_mutex_unlock(&totalStatsLock);
+    fprintf(stream, "Peak memory: %ld KB.\n", (long)usage.ru_maxrss);
+}
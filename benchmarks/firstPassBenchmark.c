@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../headers/all_headers.h"
+
+
+/*Description: measures how the first pass scales with the number of first pass jobs (main -p N). A large source is
+  generated in memory and assembled with 1, 2, 4... jobs, and the objects of every run are compared with those of
+  the serial first pass. Built by "make firstPassBenchmark" with a larger MEMORY_SIZE, since a 256 word memory
+  only fits small sources.
+  Usage: benchmarks/firstPassBenchmark [number of statements] [max jobs]*/
+
+
+#define BENCHMARK_RUNS 3 /*every measurement is the best of this many runs*/
+
+static const char* statementTemplates[] = {
+    "mov r3, r4\n",
+    "add #5, r1\n",
+    "prn #-5\n",
+    "jmp LOOP(#1,r3)\n",
+    "cmp K, #3\n",
+    "; generated comment\n",
+    "inc r2\n",
+    "lea STR, r6\n",
+    "\n",
+    "bne LOOP\n",
+    "sub r1, K\n",
+    ".data 1,-2,3\n"
+};
+#define NUMBER_OF_TEMPLATES 12
+
+
+/*Generates a source with the given number of statements. Returns a newly allocated buffer (must be freed).*/
+static char* generateSource(int statementCount, size_t* length){
+    char* source;
+    FILE* stream = open_memstream(&source, length);
+    int i;
+
+    fputs("LOOP: mov r1, r2\n", stream);
+    for (i=0; i < statementCount; i++)
+        fputs(statementTemplates[i % NUMBER_OF_TEMPLATES], stream);
+    fputs("END: stop\nSTR: .string \"abcdef\"\nK: .data 22\n", stream);
+    fclose(stream);
+    return source;
+}
+
+
+/*Returns the current time in seconds.*/
+static double now(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+/*Assembles the source with the given number of first pass jobs. Returns the time the first pass took and
+  writes the objects into a newly allocated buffer (must be freed).*/
+static double assembleWithJobs(char* source, size_t length, int jobs, char** objects, size_t* objectsLength){
+    Assembler_Context* context = createContext(printDiagnosticToStream, stdout);
+    FILE* sourceStream = fmemopen(source, length, "r");
+    FILE* objectsStream = open_memstream(objects, objectsLength);
+    double start, end;
+
+    context->firstPassJobs = jobs;
+    setCurrentContext(context);
+    initSymbolTable();
+    initEntriesArray();
+    initMemory();
+
+    start = now();
+    firstPassFromStream("benchmark", sourceStream);
+    end = now();
+    secondPassToStreams(objectsStream, NULL, NULL);
+
+    fclose(sourceStream);
+    fclose(objectsStream);
+    freeSymbolTable();
+    freeEntriesArray();
+    freeMemory();
+    freeContext(context);
+    setCurrentContext(NULL);
+    return end - start;
+}
+
+
+int main(int argc, char** argv){
+    int statementCount = argc > 1 ? atoi(argv[1]) : 300000;
+    int maxJobs = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    size_t length, objectsLength, serialLength = 0;
+    char* source = generateSource(statementCount, &length);
+    char* objects;
+    char* serialObjects = NULL;
+    double best, serialTime = 0, time;
+    int jobs, run;
+
+    printf("first pass of %d statements (%lu bytes), memory of %d words\n", statementCount, (unsigned long)length, MEMORY_SIZE);
+    for (jobs=1; jobs <= maxJobs; jobs *= 2){
+        best = 0;
+        for (run=0; run < BENCHMARK_RUNS; run++){
+            time = assembleWithJobs(source, length, jobs, &objects, &objectsLength);
+            if (run == 0 || time < best)
+                best = time;
+            if (serialObjects == NULL){
+                serialObjects = objects;
+                serialLength = objectsLength;
+                continue;
+            }
+            if (objectsLength != serialLength || memcmp(objects, serialObjects, serialLength) != 0){
+                printf("jobs %d: objects differ from the serial first pass\n", jobs);
+                return 1;
+            }
+            free(objects);
+        }
+        if (jobs == 1)
+            serialTime = best;
+        printf("jobs %2d: %.3f seconds, speedup %.2f\n", jobs, best, serialTime / best);
+    }
+
+    free(serialObjects);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,93 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../headers/all_headers.h"
+
+
+/*Description: measures the cost of a macro lookup (getMacroBody) as the number of macros grows, next to the
+  linear strcmp scan the macro table used before it was hashed. The pre processor looks up the first token of every
+  line, and most of those tokens (operations, labels) are not macros, so half of the lookups are misses.
+  Built by "make macroTableBenchmark".
+  Usage: benchmarks/macroTableBenchmark [lookups per macro count]*/
+
+
+#define MAX_MACRO_COUNT 100000
+#define NAME_LENGTH 16
+
+
+/*Returns the current time in seconds.*/
+static double now(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+/*Linear lookup of the old macro table, kept here for comparison.*/
+static int linearLookup(char (*names)[NAME_LENGTH], int macroCount, char* name){
+    int i;
+    for (i=0; i < macroCount; i++){
+        if (strcmp(names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+int main(int argc, char** argv){
+    int lookups = argc > 1 ? atoi(argv[1]) : 1000000;
+    char (*names)[NAME_LENGTH] = malloc(MAX_MACRO_COUNT * sizeof(*names));
+    char (*queries)[NAME_LENGTH] = malloc(lookups * sizeof(*queries));
+    Assembler_Context* context = createContext(printDiagnosticToStream, stdout);
+    double start, hashedTime, linearTime;
+    int macroCount, linearLookups;
+    size_t bodyLength;
+    long found;
+    int i;
+
+    setCurrentContext(context);
+    printf("%8s %14s %14s\n", "macros", "hashed ns/op", "linear ns/op");
+    for (macroCount=10; macroCount <= MAX_MACRO_COUNT; macroCount *= 10){
+        initMacroTable();
+        for (i=0; i < macroCount; i++){
+            sprintf(names[i], "macro%d", i);
+            beginMacroBody();
+            appendMacroBody("inc r1\n", 7);
+            enterMacro(names[i], "");
+        }
+        for (i=0; i < lookups; i++){
+            if (i % 2 == 0)
+                strcpy(queries[i], names[(int)(((long)i * 7919) % macroCount)]);
+            else sprintf(queries[i], "label%d", i); /*not a macro*/
+        }
+
+        found = 0;
+        start = now();
+        for (i=0; i < lookups; i++)
+            found += getMacroBody(queries[i], &bodyLength) != NULL;
+        hashedTime = (now() - start) / lookups;
+
+        /*the linear scan gets fewer lookups, it would take minutes on the larger tables*/
+        linearLookups = lookups / (macroCount / 10 + 1) + 2;
+        start = now();
+        for (i=0; i < linearLookups; i++)
+            found += linearLookup(names, macroCount, queries[i]) >= 0;
+        linearTime = (now() - start) / linearLookups;
+
+        printf("%8d %14.1f %14.1f\n", macroCount, hashedTime * 1e9, linearTime * 1e9);
+        if (found < lookups / 2){
+            printf("macro lookups failed\n");
+            return 1;
+        }
+        freeMacroTable();
+    }
+
+    freeContext(context);
+    free(names);
+    free(queries);
+    return 0;
+}
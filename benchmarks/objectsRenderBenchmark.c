@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../headers/all_headers.h"
+
+
+/*Description: measures how fast the objects file is written. A memory image that fills all of MEMORY_SIZE (half
+  instructions, half data) is made of random words and written with writeMemoryToObjectsFile, which renders the
+  words from a lookup table into a buffer, and with the per word path the assembler used before: a malloc'd string
+  for every word built one bit at a time, and sprintf for every line. Both outputs are compared. Built by
+  "make objectsRenderBenchmark" with a larger MEMORY_SIZE, so that the image is large enough to time.
+  Usage: benchmarks/objectsRenderBenchmark [runs]*/
+
+
+/*Returns the current time in seconds.*/
+static double now(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+/*convertToBinary of the old renderer, kept here for comparison.*/
+static char* convertToBinary(unsigned int operand, int length){
+    int c;
+    int i = 0;
+    char* bin = malloc(sizeof(char) * length + 1);
+
+    while (i < length){
+        c = operand % 2;
+        if (c == 0)
+            bin[i] = BIN_ZERO;
+        else
+            bin[i] = BIN_ONE;
+
+        operand = operand / 2;
+        i++;
+    }
+    bin[i] = '\0';
+
+    /*Reverse bin so binary goes from right to left*/
+    for (i=0; i < length / 2; i++){
+        c = bin[i];
+        bin[i] = bin[length - 1 - i];
+        bin[length - 1 - i] = c;
+    }
+    return bin;
+}
+
+
+/*Writes the words like the old writeMemoryToObjectsFile, one string and one sprintf per word.*/
+static void writeObjectsPerWord(FILE* objectsFile, Machine_Word* words, int IC, int DC){
+    char currentLine[wordSize * sizeof(int)];
+    char address[sizeof(int) * ADDRESS_LENGTH];
+    char dataSize[sizeof(int) * DATA_LENGTH];
+    char* bin;
+    int i;
+
+    sprintf(dataSize, "\t\t%d %d\n", IC - MEMORY_START, DC);
+    fputs(dataSize, objectsFile);
+    for (i=MEMORY_START; i < IC + DC; i++){
+        bin = convertToBinary(words[i], wordSize);
+        sprintf(address, "0%d", i);
+        sprintf(currentLine, "%s\t%s\n", address, bin);
+        fputs(currentLine, objectsFile);
+        free(bin);
+    }
+}
+
+
+/*Writes the objects of the memory of the current context to stream and returns the time it took.*/
+static double timeTableRenderer(FILE* stream){
+    double start = now();
+    writeMemoryToObjectsFile(stream);
+    fflush(stream);
+    return now() - start;
+}
+
+
+/*Writes the objects of words to stream like the old renderer and returns the time it took.*/
+static double timePerWordRenderer(FILE* stream, Machine_Word* words, int IC, int DC){
+    double start = now();
+    writeObjectsPerWord(stream, words, IC, DC);
+    fflush(stream);
+    return now() - start;
+}
+
+
+int main(int argc, char** argv){
+    int runs = argc > 1 ? atoi(argv[1]) : 3;
+    int IC = MEMORY_SIZE / 2;
+    int DC = MEMORY_SIZE - IC;
+    Machine_Word* words = malloc(MEMORY_SIZE * sizeof(Machine_Word)); /*the words by address*/
+    Assembler_Context* context = createContext(printDiagnosticToStream, stdout);
+    FILE* nullStream = fopen("/dev/null", "w");
+    FILE* tableStream;
+    FILE* perWordStream;
+    char* tableOutput;
+    char* perWordOutput;
+    size_t tableLength, perWordLength;
+    double tableTime = 0, perWordTime = 0, time;
+    int i;
+
+    setCurrentContext(context);
+    initMemory();
+    initIC();
+    srand(1);
+    for (i=MEMORY_START; i < IC; i++){
+        words[i] = convertToWord(rand());
+        writeToInstructionArray(words[i]);
+        incrementInstructionCounter();
+    }
+    for (i=0; i < DC; i++){
+        words[IC + i] = convertToWord(rand());
+        writeToDataArray(words[IC + i]);
+        incrementDataCounter();
+    }
+
+    tableStream = open_memstream(&tableOutput, &tableLength);
+    perWordStream = open_memstream(&perWordOutput, &perWordLength);
+    writeMemoryToObjectsFile(tableStream);
+    writeObjectsPerWord(perWordStream, words, IC, DC);
+    fclose(tableStream);
+    fclose(perWordStream);
+    if (tableLength != perWordLength || memcmp(tableOutput, perWordOutput, tableLength) != 0){
+        printf("the objects of the renderers differ\n");
+        return 1;
+    }
+
+    for (i=0; i < runs; i++){
+        time = timeTableRenderer(nullStream);
+        if (i == 0 || time < tableTime)
+            tableTime = time;
+        time = timePerWordRenderer(nullStream, words, IC, DC);
+        if (i == 0 || time < perWordTime)
+            perWordTime = time;
+    }
+
+    printf("%d words, %lu bytes of objects (best of %d runs)\n", IC + DC - MEMORY_START, (unsigned long)tableLength, runs);
+    printf("%-10s %10s %12s\n", "renderer", "seconds", "ns/word");
+    printf("%-10s %10.4f %12.1f\n", "table", tableTime, tableTime * 1e9 / (IC + DC - MEMORY_START));
+    printf("%-10s %10.4f %12.1f\n", "per word", perWordTime, perWordTime * 1e9 / (IC + DC - MEMORY_START));
+
+    fclose(nullStream);
+    free(tableOutput);
+    free(perWordOutput);
+    free(words);
+    freeMemory();
+    freeContext(context);
+    setCurrentContext(NULL);
+    return 0;
+}
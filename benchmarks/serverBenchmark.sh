@@ -0,0 +1,48 @@
+#!/bin/sh
+# Compares the throughput of assembling many files with one main process per file
+# against a single client of a running assembler server (main --serve).
+# Usage: benchmarks/serverBenchmark.sh [number of files]   (run from the repository root after make)
+
+FILES=${1:-500}
+ROOT=$(pwd)
+WORK=$(mktemp -d)
+SOCKET=$WORK/assembler.sock
+
+i=0
+while [ $i -lt $FILES ]; do
+    cp test1.as $WORK/file$i.as
+    i=$((i + 1))
+done
+NAMES=$(cd $WORK && ls *.as | sed 's/\.as$//')
+
+now(){
+    date +%s.%N
+}
+
+report(){
+    awk -v name="$1" -v start="$2" -v end="$3" -v files="$FILES" 'BEGIN { printf "%s: %.3f seconds for %d files\n", name, end - start, files }'
+}
+
+cd $WORK
+
+start=$(now)
+for name in $NAMES; do
+    $ROOT/main $name > /dev/null
+done
+report "process per file" $start $(now)
+
+$ROOT/main --serve $SOCKET > /dev/null &
+sleep 0.5
+
+start=$(now)
+$ROOT/client $SOCKET $NAMES > /dev/null
+report "server, paths" $start $(now)
+
+start=$(now)
+$ROOT/client $SOCKET --inline $NAMES > /dev/null
+report "server, inline sources" $start $(now)
+
+$ROOT/client $SOCKET --shutdown > /dev/null
+wait
+cd $ROOT
+rm -rf $WORK
@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../headers/all_headers.h"
+
+
+/*Description: measures the symbol table with many labels. First the cost of a lookup by name (getSymbol) and by
+  value (getSymbolByValue) as the number of labels grows, next to the linear scan the symbol table used before it was
+  hashed. The second pass looks up every word of the instruction array, and most of those words are not label names,
+  so half of the lookups are misses. Then a generated program that declares and references the largest number of
+  labels is assembled, and the time of the second pass is printed. Built by "make symbolTableBenchmark" with a larger
+  MEMORY_SIZE, since a 256 word memory only fits small sources.
+  Usage: benchmarks/symbolTableBenchmark [lookups per label count] [labels of the program]*/
+
+
+#define MAX_LABEL_COUNT 100000
+#define NAME_LENGTH 16
+
+
+/*Returns the current time in seconds.*/
+static double now(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+/*Linear lookup of the old symbol table, kept here for comparison.*/
+static int linearLookup(char (*names)[NAME_LENGTH], int labelCount, char* name){
+    int i;
+    for (i=0; i < labelCount; i++){
+        if (strcmp(names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+/*Generates a program that declares labelCount labels and references each of them. Returns a newly allocated buffer
+  (must be freed).*/
+static char* generateProgram(int labelCount, size_t* length){
+    char* source;
+    FILE* stream = open_memstream(&source, length);
+    int i;
+
+    for (i=0; i < labelCount; i++)
+        fprintf(stream, "L%d: inc r1\n", i);
+    for (i=0; i < labelCount; i++)
+        fprintf(stream, "jmp L%d\n", (int)(((long)i * 7919) % labelCount));
+    fputs("stop\n", stream);
+    fclose(stream);
+    return source;
+}
+
+
+/*Assembles a program with labelCount labels and returns the time its second pass took.*/
+static double timeSecondPass(int labelCount){
+    Assembler_Context* context = createContext(printDiagnosticToStream, stdout);
+    size_t length, objectsLength;
+    char* source = generateProgram(labelCount, &length);
+    char* objects;
+    FILE* sourceStream = fmemopen(source, length, "r");
+    FILE* objectsStream = open_memstream(&objects, &objectsLength);
+    double start, end;
+
+    setCurrentContext(context);
+    initSymbolTable();
+    initEntriesArray();
+    initMemory();
+
+    firstPassFromStream("benchmark", sourceStream);
+    start = now();
+    secondPassToStreams(objectsStream, NULL, NULL);
+    end = now();
+
+    fclose(sourceStream);
+    fclose(objectsStream);
+    free(objects);
+    free(source);
+    freeSymbolTable();
+    freeEntriesArray();
+    freeMemory();
+    freeContext(context);
+    setCurrentContext(NULL);
+    return end - start;
+}
+
+
+int main(int argc, char** argv){
+    int lookups = argc > 1 ? atoi(argv[1]) : 1000000;
+    int programLabels = argc > 2 ? atoi(argv[2]) : MAX_LABEL_COUNT;
+    char (*names)[NAME_LENGTH] = malloc(MAX_LABEL_COUNT * sizeof(*names));
+    char (*queries)[NAME_LENGTH] = malloc(lookups * sizeof(*queries));
+    Assembler_Context* context = createContext(printDiagnosticToStream, stdout);
+    double start, hashedTime, valueTime, linearTime;
+    int labelCount, linearLookups;
+    long found;
+    int i;
+
+    setCurrentContext(context);
+    printf("%8s %14s %14s %14s\n", "labels", "hashed ns/op", "by value ns/op", "linear ns/op");
+    for (labelCount=1000; labelCount <= MAX_LABEL_COUNT; labelCount *= 10){
+        initSymbolTable();
+        for (i=0; i < labelCount; i++){
+            sprintf(names[i], "LABEL%d", i);
+            enterSymbol(names[i], MEMORY_START + i, CODETAG, RELOCATABLE);
+        }
+        for (i=0; i < lookups; i++){
+            if (i % 2 == 0)
+                strcpy(queries[i], names[(int)(((long)i * 7919) % labelCount)]);
+            else strcpy(queries[i], "..../..//..//."); /*an encoded word, not a label*/
+        }
+
+        found = 0;
+        start = now();
+        for (i=0; i < lookups; i++)
+            found += getSymbol(queries[i]) != NULL;
+        hashedTime = (now() - start) / lookups;
+
+        start = now();
+        for (i=0; i < lookups; i++)
+            found += getSymbolByValue(MEMORY_START + (int)(((long)i * 7919) % labelCount)) != NULL;
+        valueTime = (now() - start) / lookups;
+
+        /*the linear scan gets fewer lookups, it would take minutes on the larger tables*/
+        linearLookups = lookups / (labelCount / 10 + 1) + 2;
+        start = now();
+        for (i=0; i < linearLookups; i++)
+            found += linearLookup(names, labelCount, queries[i]) >= 0;
+        linearTime = (now() - start) / linearLookups;
+
+        printf("%8d %14.1f %14.1f %14.1f\n", labelCount, hashedTime * 1e9, valueTime * 1e9, linearTime * 1e9);
+        if (found < lookups / 2 + lookups){
+            printf("label lookups failed\n");
+            return 1;
+        }
+        freeSymbolTable();
+    }
+    freeContext(context);
+    setCurrentContext(NULL);
+
+    printf("second pass of a program with %d labels: %.3f seconds\n", programLabels, timeSecondPass(programLabels));
+    free(names);
+    free(queries);
+    return 0;
+}
@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "headers/constants.h"
+#include "headers/cache.h"
+#include "headers/includes.h"
+
+
+/*Description: this file contains the build cache (main --cache <directory>). Every entry of the cache is a directory
+  named after a hash of the assembler version, the file name and the contents of the source file. It holds the output
+  files that assembling the source created and everything the assembler printed for it, so an unchanged source does
+  not go through the pre processor and the two passes again. The entry also keeps everything that was hashed, which is
+  compared on a hit, so two sources with the same hash never share an entry.*/
+
+
+#define CACHE_DIAGNOSTICS_FILE "diagnostics"
+#define CACHE_SOURCE_FILE "source"
+
+static const char* cachedFileTypes[] = {POST_PREPROCESSOR_FILETYPE, /*must stay first, see withExpandedSource*/
+    OBJECT_FILETYPE, EXTERNALS_FILETYPE, ENTRIES_FILETYPE, BINARY_OBJECT_FILETYPE};
+#define NUMBER_OF_CACHED_FILETYPES 5
+
+static int cacheHits;
+static int cacheMisses;
+static pthread_mutex_t cacheStatsLock = PTHREAD_MUTEX_INITIALIZER; /*files of a batch (-j N) are looked up at the same time*/
+
+
+/*Receives two strings and returns a newly allocated string with both of them (must be freed).*/
+static char* joinPath(const char* first, const char* second){
+    char* path = malloc(strlen(first) + strlen(second) + 2);
+    sprintf(path, "%s/%s", first, second);
+    return path;
+}
+
+
+/*Receives a file name and a file type and returns the name of the file (must be freed).*/
+static char* getFileNameWithType(const char* fileName, const char* fileType){
+    char* path = malloc(strlen(fileName) + strlen(fileType) + 1);
+    sprintf(path, "%s%s", fileName, fileType);
+    return path;
+}
+
+
+/*Copies the file in sourcePath to destinationPath. Returns 1 if successful, 0 if sourcePath does not exist
+  or destinationPath could not be written.*/
+static int copyFile(const char* sourcePath, const char* destinationPath){
+    char buffer[BUFSIZ];
+    size_t length;
+    FILE* source = fopen(sourcePath, "r");
+    FILE* destination;
+    int success = 1;
+
+    if (source == NULL)
+        return 0;
+    destination = fopen(destinationPath, "w");
+    if (destination == NULL){
+        fclose(source);
+        return 0;
+    }
+    while ((length = fread(buffer, 1, sizeof(buffer), source)) > 0){
+        if (fwrite(buffer, 1, length, destination) != length)
+            success = 0;
+    }
+    fclose(source);
+    if (fclose(destination) != 0)
+        success = 0;
+    return success;
+}
+
+
+/*Updates a pair of hashes with the given bytes.*/
+static void hashBytes(unsigned long* fnvHash, unsigned long* sdbmHash, const char* bytes, size_t length){
+    size_t i;
+    for (i=0; i < length; i++){
+        *fnvHash = ((*fnvHash ^ (unsigned char)bytes[i]) * 16777619UL) & 0xffffffffUL;
+        *sdbmHash = ((unsigned char)bytes[i] + (*sdbmHash << 6) + (*sdbmHash << 16) - *sdbmHash) & 0xffffffffUL;
+    }
+}
+
+
+/*Receives a file and returns 1 if its contents are the given bytes, 0 otherwise (or if it can not be read).*/
+static int hasFileContents(const char* path, const char* bytes, size_t length){
+    char buffer[BUFSIZ];
+    size_t readLength;
+    size_t position = 0;
+    FILE* file = fopen(path, "r");
+    int same = 1;
+
+    if (file == NULL)
+        return 0;
+    while (same && (readLength = fread(buffer, 1, sizeof(buffer), file)) > 0){
+        if (position + readLength > length || memcmp(buffer, bytes + position, readLength) != 0)
+            same = 0;
+        position += readLength;
+    }
+    fclose(file);
+    return same && position == length;
+}
+
+
+/*Writes the contents of a source file (without the .as ending) to the key source of a cache key and, after every
+  include directive, the name and the contents of the included file, so the key changes when an included file does.
+  Included files are followed at most MAX_INCLUDE_DEPTH deep, which also ends include cycles.
+  Returns 1 if successful, 0 if the file cannot be read.*/
+static int readKeySource(FILE* keySource, char* fileName, int depth){
+    char line[BUFSIZ];
+    size_t length;
+    char* includedFileName;
+    char* sourcePath = getFileNameWithType(fileName, SOURCE_FILETYPE);
+    FILE* sourceFile = fopen(sourcePath, "r");
+
+    free(sourcePath);
+    if (sourceFile == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), sourceFile) != NULL){
+        length = strlen(line);
+        fwrite(line, 1, length, keySource);
+        if (depth < MAX_INCLUDE_DEPTH && (includedFileName = getIncludedFileName(line, fileName)) != NULL){
+            fwrite(includedFileName, 1, strlen(includedFileName) + 1, keySource);
+            readKeySource(keySource, includedFileName, depth + 1);
+            free(includedFileName);
+        }
+    }
+    fclose(sourceFile);
+    return 1;
+}
+
+
+/*Receives the name of a source file (without the .as ending), whether the .am file is written (main --emit-am),
+  whether it is assembled in large memory mode (main --large-memory) and whether a binary object file is written
+  (main --format=bin), and returns the key of its cache entry (must be freed with freeCacheKey). The key is made of
+  the assembler version, the .am, memory and format options, the file name (it is part of the messages) and the
+  contents of the file and of the files it includes, which are kept in the key as its source. Returns NULL if the file
+  cannot be read, in which case the file is assembled without the cache.*/
+Cache_Key* getCacheKey(char* fileName, int withExpandedSource, int largeMemory, int binaryObjects){
+    unsigned long fnvHash = 2166136261UL;
+    unsigned long sdbmHash = 0;
+    Cache_Key* key = malloc(sizeof(Cache_Key));
+    FILE* keySource = open_memstream(&key->source, &key->sourceLength);
+    int success;
+
+    fwrite(ASSEMBLER_VERSION, 1, strlen(ASSEMBLER_VERSION) + 1, keySource);
+    fwrite(withExpandedSource ? "am" : "", 1, withExpandedSource ? 3 : 1, keySource);
+    fwrite(largeMemory ? "large" : "", 1, largeMemory ? 6 : 1, keySource);
+    fwrite(binaryObjects ? "bin" : "", 1, binaryObjects ? 4 : 1, keySource);
+    fwrite(fileName, 1, strlen(fileName) + 1, keySource);
+    success = readKeySource(keySource, fileName, 0);
+    fclose(keySource);
+    if (!success){
+        free(key->source);
+        free(key);
+        return NULL;
+    }
+
+    hashBytes(&fnvHash, &sdbmHash, key->source, key->sourceLength);
+    key->name = malloc(3 * 8 + 3);
+    sprintf(key->name, "%08lx%08lx-%lx", fnvHash, sdbmHash, (unsigned long)key->sourceLength);
+    return key;
+}
+
+
+/*Frees a key returned by getCacheKey.*/
+void freeCacheKey(Cache_Key* key){
+    if (key == NULL)
+        return;
+    free(key->name);
+    free(key->source);
+    free(key);
+}
+
+
+/*Receives the name of a source file (without the .as ending) and whether the .am file is written, and removes the
+  output files that the cache stores for it, so that only the outputs of the next run are found and stored.*/
+void removeCachedOutputs(char* fileName, int withExpandedSource){
+    char* outputPath;
+    int i;
+
+    for (i=withExpandedSource ? 0 : 1; i < NUMBER_OF_CACHED_FILETYPES; i++){
+        outputPath = getFileNameWithType(fileName, cachedFileTypes[i]);
+        remove(outputPath);
+        free(outputPath);
+    }
+}
+
+
+/*Records a cache hit or miss.*/
+static void countCacheLookup(int hit){
+    pthread_mutex_lock(&cacheStatsLock);
+    if (hit)
+        cacheHits++;
+    else
+        cacheMisses++;
+    pthread_mutex_unlock(&cacheStatsLock);
+}
+
+
+/*Looks up the entry of key in the cache directory. If it exists and was stored for the same source, its output files
+  are restored for fileName and its messages are printed to the diagnostics stream, and 1 is returned. Returns 0 if
+  there is no such entry. The .am file is only restored if withExpandedSource is set, like it is only written by
+  main --emit-am.*/
+int restoreFromCache(char* cacheDirectory, Cache_Key* key, char* fileName, int withExpandedSource, FILE* diagnostics){
+    char* entryPath = joinPath(cacheDirectory, key->name);
+    char* cachedPath = joinPath(entryPath, CACHE_SOURCE_FILE);
+    char* outputPath;
+    char buffer[BUFSIZ];
+    size_t length;
+    FILE* cachedDiagnostics = NULL;
+    int i;
+
+    if (hasFileContents(cachedPath, key->source, key->sourceLength)){
+        free(cachedPath);
+        cachedPath = joinPath(entryPath, CACHE_DIAGNOSTICS_FILE);
+        cachedDiagnostics = fopen(cachedPath, "r");
+    }
+    free(cachedPath);
+    if (cachedDiagnostics == NULL){
+        /*every complete entry has a diagnostics file, even if it is empty, and a different source is a miss*/
+        free(entryPath);
+        countCacheLookup(0);
+        return 0;
+    }
+
+    for (i=withExpandedSource ? 0 : 1; i < NUMBER_OF_CACHED_FILETYPES; i++){
+        cachedPath = joinPath(entryPath, cachedFileTypes[i] + 1); /*the entry holds "am", "ob"...*/
+        outputPath = getFileNameWithType(fileName, cachedFileTypes[i]);
+        if (!copyFile(cachedPath, outputPath))
+            remove(outputPath); /*this output was not created when the source was assembled*/
+        free(cachedPath);
+        free(outputPath);
+    }
+
+    while ((length = fread(buffer, 1, sizeof(buffer), cachedDiagnostics)) > 0)
+        fwrite(buffer, 1, length, diagnostics);
+    fclose(cachedDiagnostics);
+
+    free(entryPath);
+    countCacheLookup(1);
+    return 1;
+}
+
+
+/*Stores the output files of fileName and the messages printed while assembling it as the entry of key in the cache
+  directory. The entry is written into a temporary directory first, so a file that is assembled at the same time
+  by another process never sees half an entry. A .am file is only stored if withExpandedSource is set, otherwise it
+  is not an output of this run. The outputs must have been removed with removeCachedOutputs before the run, so that
+  the files of an earlier run are not stored.*/
+void storeInCache(char* cacheDirectory, Cache_Key* key, char* fileName, int withExpandedSource, char* diagnostics, size_t diagnosticsLength){
+    char* entryPath = joinPath(cacheDirectory, key->name);
+    char* temporaryPath = malloc(strlen(entryPath) + strlen(".XXXXXX") + 1);
+    char* cachedPath;
+    char* outputPath;
+    FILE* cachedDiagnostics;
+    int i;
+
+    mkdir(cacheDirectory, 0777);
+    sprintf(temporaryPath, "%s.XXXXXX", entryPath);
+    if (mkdtemp(temporaryPath) == NULL){
+        free(temporaryPath);
+        free(entryPath);
+        return;
+    }
+
+    for (i=withExpandedSource ? 0 : 1; i < NUMBER_OF_CACHED_FILETYPES; i++){
+        cachedPath = joinPath(temporaryPath, cachedFileTypes[i] + 1);
+        outputPath = getFileNameWithType(fileName, cachedFileTypes[i]);
+        copyFile(outputPath, cachedPath);
+        free(cachedPath);
+        free(outputPath);
+    }
+
+    cachedPath = joinPath(temporaryPath, CACHE_SOURCE_FILE);
+    cachedDiagnostics = fopen(cachedPath, "w"); /*the source, then the diagnostics*/
+    if (cachedDiagnostics != NULL){
+        fwrite(key->source, 1, key->sourceLength, cachedDiagnostics);
+        if (fclose(cachedDiagnostics) != 0)
+            cachedDiagnostics = NULL;
+    }
+    free(cachedPath);
+
+    if (cachedDiagnostics != NULL){
+        cachedPath = joinPath(temporaryPath, CACHE_DIAGNOSTICS_FILE);
+        cachedDiagnostics = fopen(cachedPath, "w");
+        if (cachedDiagnostics != NULL){
+            fwrite(diagnostics, 1, diagnosticsLength, cachedDiagnostics);
+            fclose(cachedDiagnostics);
+        }
+        free(cachedPath);
+    }
+
+    if (cachedDiagnostics == NULL || rename(temporaryPath, entryPath) != 0){
+        /*the entry could not be written, or the same source was stored in the meantime*/
+        for (i=0; i < NUMBER_OF_CACHED_FILETYPES; i++){
+            cachedPath = joinPath(temporaryPath, cachedFileTypes[i] + 1);
+            remove(cachedPath);
+            free(cachedPath);
+        }
+        cachedPath = joinPath(temporaryPath, CACHE_DIAGNOSTICS_FILE);
+        remove(cachedPath);
+        free(cachedPath);
+        cachedPath = joinPath(temporaryPath, CACHE_SOURCE_FILE);
+        remove(cachedPath);
+        free(cachedPath);
+        rmdir(temporaryPath);
+    }
+    free(temporaryPath);
+    free(entryPath);
+}
+
+
+/*Prints the number of cache hits and misses (main --cache-stats).*/
+void printCacheStats(FILE* stream){
+    pthread_mutex_lock(&cacheStatsLock);
+    fprintf(stream, "\nCache: %d hits, %d misses.\n", cacheHits, cacheMisses);
+    pthread_mutex_unlock(&cacheStatsLock);
+}
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "headers/constants.h"
+#include "headers/socketUtils.h"
+
+
+/*Description: this file contains the client of the assembler server (main --serve <socket>). The client sends each
+  file to the server, either by its path or with its source (--inline), and writes the outputs it gets back into the
+  same files and messages that main would have created. Paths are opened by the server, so they should be relative
+  to the directory the server was started in, or absolute.*/
+
+
+/*Receives a file name and a file type and returns the name of the output file (must be freed).*/
+static char* getOutputFileName(char* fileName, char* fileType){
+    char* outputFileName = malloc(strlen(fileName) + strlen(fileType) + 1);
+    strcpy(outputFileName, fileName);
+    strcat(outputFileName, fileType);
+    return outputFileName;
+}
+
+
+/*Receives a file name, a file type and the contents of the file and writes them into the file.*/
+static void writeOutputFile(char* fileName, char* fileType, char* data, size_t length){
+    char* outputFileName = getOutputFileName(fileName, fileType);
+    FILE* outputFile = fopen(outputFileName, "w");
+    if (outputFile != NULL){
+        fwrite(data, 1, length, outputFile);
+        fclose(outputFile);
+    }
+    free(outputFileName);
+}
+
+
+/*Removes the output file of the given type, left over from an earlier run.*/
+static void removeOutputFile(char* fileName, char* fileType){
+    char* outputFileName = getOutputFileName(fileName, fileType);
+    remove(outputFileName);
+    free(outputFileName);
+}
+
+
+/*Reads the source of a file (<fileName>.as) into a newly allocated buffer. Returns NULL if the file does not exist.*/
+static char* readSourceFile(char* fileName, size_t* length){
+    char* sourceFileName = getOutputFileName(fileName, SOURCE_FILETYPE);
+    FILE* sourceFile = fopen(sourceFileName, "r");
+    char* source;
+    free(sourceFileName);
+
+    if (sourceFile == NULL)
+        return NULL;
+    fseek(sourceFile, 0, SEEK_END);
+    *length = ftell(sourceFile);
+    fseek(sourceFile, 0, SEEK_SET);
+    source = malloc(*length + 1);
+    *length = fread(source, 1, *length, sourceFile);
+    fclose(sourceFile);
+    return source;
+}
+
+
+/*Sends a request for a single file and handles the response. The .am file is only written if emitExpandedSource
+  is set. Returns 0 if the connection to the server failed.*/
+static int assembleRemotely(int connection, Socket_Reader* reader, char* fileName, int sendSource, int emitExpandedSource){
+    char line[MAX_REQUEST_LINE_LENGTH];
+    char kind[MAX_REQUEST_LINE_LENGTH];
+    char* data;
+    char* source = NULL;
+    size_t length;
+    int success;
+    int hasExpandedSource = 0;
+    int sectionStatus;
+
+    if (strlen(fileName) + strlen(REQUEST_SOURCE) + 32 > MAX_REQUEST_LINE_LENGTH){
+        fprintf(stdout, "Error: file name %s is too long.\n", fileName);
+        return 1;
+    }
+
+    if (sendSource){
+        source = readSourceFile(fileName, &length);
+        if (source == NULL){
+            fprintf(stdout, "Error: Failed to open %s for processing.\nExiting program.", fileName);
+            return 1;
+        }
+        sprintf(line, "%s %lu %s\n", REQUEST_SOURCE, (unsigned long)length, fileName);
+        success = writeSocketBytes(connection, line, strlen(line)) && writeSocketBytes(connection, source, length);
+        free(source);
+    }
+    else {
+        sprintf(line, "%s %s\n", REQUEST_FILE, fileName);
+        success = writeSocketBytes(connection, line, strlen(line));
+    }
+    if (!success || readSocketLine(reader, line, sizeof(line)) < 0 || sscanf(line, RESPONSE_RESULT " %d", &success) != 1)
+        return 0;
+
+    /*Outputs of an earlier run are removed, so only the outputs of this run are left*/
+    removeOutputFile(fileName, OBJECT_FILETYPE);
+    removeOutputFile(fileName, EXTERNALS_FILETYPE);
+    removeOutputFile(fileName, ENTRIES_FILETYPE);
+
+    while ((sectionStatus = readSocketSection(reader, kind, &data, &length)) == 1){
+        if (strcmp(kind, "am") == 0){
+            if (emitExpandedSource)
+                writeOutputFile(fileName, POST_PREPROCESSOR_FILETYPE, data, length);
+            hasExpandedSource = 1;
+        }
+        else if (strcmp(kind, "ob") == 0)
+            writeOutputFile(fileName, OBJECT_FILETYPE, data, length);
+        else if (strcmp(kind, "ext") == 0)
+            writeOutputFile(fileName, EXTERNALS_FILETYPE, data, length);
+        else if (strcmp(kind, "ent") == 0)
+            writeOutputFile(fileName, ENTRIES_FILETYPE, data, length);
+        else if (strcmp(kind, "diagnostics") == 0)
+            fwrite(data, 1, length, stdout);
+        free(data);
+    }
+    if (sectionStatus < 0)
+        return 0;
+
+    if (!hasExpandedSource){
+        /*the pre processor failed, so there is no .am file and no message about the output files*/
+        if (emitExpandedSource)
+            removeOutputFile(fileName, POST_PREPROCESSOR_FILETYPE);
+        return 1;
+    }
+    if (success)
+        fprintf(stdout, "\nProgram complete: You can find the output files for %s in the directory.\n", fileName);
+    else
+        fprintf(stdout, "\nNo output files created because of error/s in the source code in %s.as.\n", fileName);
+    return 1;
+}
+
+
+int main(int argc, char** argv){
+    int i;
+    int connection;
+    int sendSource = 0; /*bool, --inline sends the source of the files instead of their paths*/
+    int shutdownServer = 0; /*bool, --shutdown stops the server after all files are assembled*/
+    int emitExpandedSource = 0; /*bool, --emit-am writes the .am files like main --emit-am*/
+    char line[MAX_REQUEST_LINE_LENGTH];
+    Socket_Reader* reader;
+
+    if (argc < 2){
+        fprintf(stdout, "Usage: client <socket> [--inline] [--shutdown] [--emit-am] file1 file2 ...\n");
+        return 1;
+    }
+
+    connection = connectToSocket(argv[1]);
+    if (connection < 0){
+        fprintf(stdout, "Error: Failed to connect to the assembler server on %s.\n", argv[1]);
+        return 1;
+    }
+    reader = malloc(sizeof(Socket_Reader));
+    initSocketReader(reader, connection);
+
+    for (i=2; i<argc; i++){
+        if (strcmp(argv[i], "--inline") == 0)
+            sendSource = 1;
+        else if (strcmp(argv[i], "--shutdown") == 0)
+            shutdownServer = 1;
+        else if (strcmp(argv[i], "--emit-am") == 0)
+            emitExpandedSource = 1;
+        else if (!assembleRemotely(connection, reader, argv[i], sendSource, emitExpandedSource)){
+            fprintf(stdout, "Error: Lost the connection to the assembler server.\n");
+            break;
+        }
+    }
+
+    if (shutdownServer){
+        /*waits for the response so the server has stopped accepting connections when the client exits*/
+        writeSocketBytes(connection, REQUEST_SHUTDOWN "\n", strlen(REQUEST_SHUTDOWN) + 1);
+        while (readSocketLine(reader, line, sizeof(line)) >= 0 && strcmp(line, RESPONSE_END) != 0);
+    }
+
+    free(reader);
+    close(connection);
+    return 1;
+}
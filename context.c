@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#include "headers/context.h"
+#include "headers/sourceIndex.h"
+#include "headers/arena.h"
+#include "headers/lexer.h"
+
+
+/*Description: this file contains the assembler context, which holds all of the state of the file currently being
+  assembled (counters, memory, symbol and macro tables, arena). Every thread has its own current context so that several
+  files can be assembled at the same time.*/
+
+
+static pthread_key_t contextKey; /*holds the current context of each thread*/
+static pthread_once_t contextKeyOnce = PTHREAD_ONCE_INIT;
+
+
+/*Creates the thread specific key that holds the current context.*/
+static void createContextKey(){
+    pthread_key_create(&contextKey, NULL);
+}
+
+
+/*Receives the sink that diagnostics should be passed to and creates a new empty context.
+  The tables of the context are created by the init functions of each module.*/
+Assembler_Context* createContext(Diagnostics_Sink sink, void* sinkData){
+    Assembler_Context* context = calloc(1, sizeof(Assembler_Context));
+    context->outputStatus = 1;
+    context->firstPassJobs = 1;
+    context->binaryObjects = 0;
+    context->crossReference = 0;
+    context->sink = sink;
+    context->sinkData = sinkData;
+    context->arena = createArena();
+    context->tokens = createTokenStream();
+    return context;
+}
+
+
+/*Resets the per file state of a context (line numbers, output flags, source) so that it can be
+  used for the next file. The tables of the context are reset by the reset functions of each module.*/
+void resetContext(Assembler_Context* context){
+    context->lineNumber = 0;
+    context->statementIndent = 0;
+    context->outputStatus = 1;
+    context->outputExterns = 0;
+    context->outputEntries = 0;
+    context->currentFileName = NULL;
+    context->preProcessorLineNumber = 0;
+    context->preProcessorFileName = NULL;
+    context->currentInstructionType = 0;
+    if (context->sourceIndex != NULL)
+        freeSourceIndex(context->sourceIndex);
+    context->sourceIndex = NULL;
+    resetArena(context->arena);
+}
+
+
+/*Frees context from memory.*/
+void freeContext(Assembler_Context* context){
+    if (getCurrentContext() == context)
+        setCurrentContext(NULL);
+    if (context->sourceIndex != NULL)
+        freeSourceIndex(context->sourceIndex);
+    freeArena(context->arena);
+    freeTokenStream(context->tokens);
+    free(context);
+}
+
+
+/*Sets the context that the calling thread is assembling with.*/
+void setCurrentContext(Assembler_Context* context){
+    pthread_once(&contextKeyOnce, createContextKey);
+    pthread_setspecific(contextKey, context);
+}
+
+
+/*Returns the context that the calling thread is assembling with.*/
+Assembler_Context* getCurrentContext(){
+    pthread_once(&contextKeyOnce, createContextKey);
+    return pthread_getspecific(contextKey);
+}
+
+
+/*Diagnostics sink that prints each message to the stream given as sink data.*/
+void printDiagnosticToStream(void* stream, const char* message){
+    fputs(message, stream);
+}
+
+
+/*Receives a printf style format and its arguments and passes the formatted message to the diagnostics sink
+  of the current context. Messages are printed to stdout when there is no context.*/
+void reportDiagnostic(const char* format, ...){
+    Assembler_Context* context = getCurrentContext();
+    va_list args;
+    char* message;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    message = malloc(length + 1);
+    va_start(args, format);
+    vsnprintf(message, length + 1, format, args);
+    va_end(args);
+
+    if (context == NULL || context->sink == NULL)
+        fputs(message, stdout);
+    else context->sink(context->sinkData, message);
+    free(message);
+}
@@ -1,13 +1,23 @@
-#include "assembler.h"
-#include "preProcessor.h"
-#include "stringUtils.h"
-#include "constants.h"
-#include "memory.h"
-#include "errors.h"
-#include "assembler.h"
-#include "operations.h"
-#include "utils.h"
-#include "statements.h"
-#include "labels.h"
-#include "operands.h"
-#include "macros.h"
\ No newline at end of file
+#include "assembler.h"
+#include "preProcessor.h"
+#include "stringUtils.h"
+#include "constants.h"
+#include "utils.h"
+#include "memory.h"
+#include "errors.h"
+#include "assembler.h"
+#include "operations.h"
+#include "statements.h"
+#include "labels.h"
+#include "operands.h"
+#include "macros.h"
+#include "context.h"
+#include "server.h"
+#include "cache.h"
+#include "parallelFirstPass.h"
+#include "lineStream.h"
+#include "includes.h"
+#include "sourceIndex.h"
+#include "arena.h"
+#include "lexer.h"
+#include "watch.h"
\ No newline at end of file
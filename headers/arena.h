@@ -0,0 +1,18 @@
+struct Arena_Block;
+
+/*A position in the scratch memory of an arena, see arenaMark.*/
+typedef struct Arena_Mark{
+    struct Arena_Block* block;
+    size_t used;
+} Arena_Mark;
+
+struct Arena* createArena();
+void resetArena(struct Arena* arena);
+void freeArena(struct Arena* arena);
+void* arenaAlloc(size_t size);
+void* arenaCalloc(size_t count, size_t size);
+char* arenaCopy(const char* text, size_t length);
+char* internString(const char* text);
+Arena_Mark arenaMark();
+void arenaRelease(Arena_Mark mark);
+void printAllocationStats(FILE* stream);
@@ -1,7 +1,20 @@
-int getLineNumber();
-int changeOutputStatus();
-char* getFileName();
-void printUndeclaredLabelReferences(char* filename, char* labelname);
-
-int firstPass(char* fileName);
+struct Line_Stream;
+
+int getLineNumber();
+int changeOutputStatus();
+char* getFileName();
+
+int handleCommandStatement(char* statement);
+int handleInstructionStatement(char* statement);
+int handleExternInstruction(char* statement);
+int handleEntryInstruction(char* statement);
+int getCommandSize(char* statement);
+int getDataSize(char* statement);
+int getStringSize(char* statement);
+
+int firstPassFromLineStream(char* fileName, struct Line_Stream* lines);
+int firstPassFromStream(char* fileName, FILE* sourceFile);
+int firstPass(char* fileName);
+int secondPassToStreams(FILE* objectsFile, FILE* externsFile, FILE* entriesFile);
+int secondPassToBinary(FILE* binaryFile);
 int secondPass(char* filename);
\ No newline at end of file
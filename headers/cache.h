@@ -0,0 +1,13 @@
+/*The key of a cache entry, see getCacheKey.*/
+typedef struct Cache_Key{
+    char* name; /*hash of the source, the name of the entry*/
+    char* source; /*everything that was hashed*/
+    size_t sourceLength;
+} Cache_Key;
+
+Cache_Key* getCacheKey(char* fileName, int withExpandedSource, int largeMemory, int binaryObjects);
+void freeCacheKey(Cache_Key* key);
+void removeCachedOutputs(char* fileName, int withExpandedSource);
+int restoreFromCache(char* cacheDirectory, Cache_Key* key, char* fileName, int withExpandedSource, FILE* diagnostics);
+void storeInCache(char* cacheDirectory, Cache_Key* key, char* fileName, int withExpandedSource, char* diagnostics, size_t diagnosticsLength);
+void printCacheStats(FILE* stream);
@@ -1,28 +1,69 @@
-#define MAX_STATEMENT_LENGTH 80
-#define wordSize 14 /*word refers to size of a cell of memory, each cell contains 14 bits*/
-#define MEMORY_SIZE 256
-#define MEMORY_START 100
-#define ADDRESS_LENGTH 4
-#define NUMBER_OF_OPERATIONS 16
-#define NUMBER_OF_REGISTERS 8
-#define MAX_INSTRUCTION_LENGTH 7 /*Max size of .data, .string, .entry, and .extern*/
-#define NUMBER_OF_INSTRUCTIONS 4
-#define BIN_ZERO '.'
-#define BIN_ONE '/'
-#define MAX_LABEL_LENGTH 30
-#define MAX_NUM_LENGTH 6 /*Because largest number with 14 digits in binary is 16,383*/
-#define COMMENT_ID ';'
-#define MAX_ASSIGNMENT_TYPES 4
-#define INITIAL_TABLE_SIZE 10
-#define DATA_LENGTH 8
-
-/*file endings*/
-#define SOURCE_FILETYPE ".as"
-#define POST_PREPROCESSOR_FILETYPE ".am"
-#define OBJECT_FILETYPE  ".ob"
-#define ENTRIES_FILETYPE ".ent"
-#define EXTERNALS_FILETYPE ".ext"
-
-/*Macro declarations*/
-#define MACRO_ID "mcr"
-#define END_MACRO_ID "endmcr"
+#define MAX_STATEMENT_LENGTH 80
+#define wordSize 14 /*word refers to size of a cell of memory, each cell contains 14 bits*/
+#define WORD_MASK ((1u << wordSize) - 1) /*the bits of a word of memory*/
+#define HALF_WORD_BITS 7 /*words are rendered as text half a word at a time*/
+#define HALF_WORD_MASK ((1u << HALF_WORD_BITS) - 1)
+#ifndef MEMORY_SIZE
+#define MEMORY_SIZE 256 /*can be set at build time, see the firstPassBenchmark target of the makefile*/
+#endif
+#define MEMORY_START 100
+#define ADDRESS_BITS 12 /*bits of the address of a label in a word*/
+#define LARGE_MEMORY_SIZE 16777216 /*words of memory in large memory mode (--large-memory)*/
+#define LARGE_ADDRESS_BITS 26 /*bits of the address of a label in a word in large memory mode*/
+#define LARGE_WORD_SIZE (LARGE_ADDRESS_BITS + 2) /*bits of a word in large memory mode, a multiple of HALF_WORD_BITS*/
+#define MEMORY_SEGMENT_SIZE 4096 /*words of memory are allocated this many at a time*/
+#define ADDRESS_LENGTH 4
+#define NUMBER_OF_OPERATIONS 16
+#define MAX_OPERATION_NAME_LENGTH 4
+#define NUMBER_OF_REGISTERS 8
+#define MAX_INSTRUCTION_LENGTH 7 /*Max size of .data, .string, .entry, and .extern*/
+#define NUMBER_OF_INSTRUCTIONS 4
+#define BIN_ZERO '.'
+#define BIN_ONE '/'
+#define MAX_LABEL_LENGTH 30
+#define MAX_NUM_LENGTH 6 /*Because largest number with 14 digits in binary is 16,383*/
+#define COMMENT_ID ';'
+#define MAX_ASSIGNMENT_TYPES 4
+#define INITIAL_TABLE_SIZE 10
+#define INITIAL_TOKENS_SIZE 16
+#define MACRO_TABLE_INITIAL_SLOTS 64 /*must be a power of two*/
+#define SYMBOL_TABLE_INITIAL_SLOTS 64 /*must be a power of two*/
+#define FIXUP_SYMBOLS_INITIAL_SLOTS 64 /*must be a power of two*/
+#define ARENA_BLOCK_SIZE 65536
+#define INTERNED_STRINGS_INITIAL_SLOTS 256 /*must be a power of two*/
+#define MACRO_BODIES_INITIAL_SIZE 1024
+#define MAX_MACRO_PARAMETERS 8
+#define MAX_INCLUDE_DEPTH 16
+#define MAX_INCLUDE_ATTEMPTS 3 /*times a changing included file is pre processed before it is used without the cache*/
+#define INITIAL_LINE_INDEX_SIZE 256
+#define DATA_LENGTH 8
+#define OBJECTS_BUFFER_SIZE 65536 /*the objects file is rendered into a buffer of this size*/
+#define OBJECTS_LINE_LENGTH (sizeof(int) * 3 + LARGE_WORD_SIZE + 3) /*longest line of the objects file: 0, address, tab, word, new line*/
+#define BINARY_OBJECT_MAGIC "ASOB" /*first 4 bytes of a binary object file (--format=bin)*/
+#define BINARY_OBJECT_VERSION 1 /*change it whenever the layout of the binary object file changes*/
+#define BINARY_OBJECT_HEADER_FIELDS 13 /*32 bit numbers in the header of a binary object file*/
+#define PARALLEL_FIRST_PASS_MIN_LENGTH 16384 /*smaller sources are not worth starting threads for*/
+#define ASSEMBLER_VERSION "1.7" /*part of the build cache keys, change it whenever the output of the assembler changes*/
+
+/*file endings*/
+#define SOURCE_FILETYPE ".as"
+#define POST_PREPROCESSOR_FILETYPE ".am"
+#define OBJECT_FILETYPE  ".ob"
+#define ENTRIES_FILETYPE ".ent"
+#define EXTERNALS_FILETYPE ".ext"
+#define BINARY_OBJECT_FILETYPE ".obj"
+#define CROSS_REFERENCE_FILETYPE ".xref"
+
+/*Macro declarations*/
+#define MACRO_ID "mcr"
+#define END_MACRO_ID "endmcr"
+#define INCLUDE_ID "include"
+
+/*Assembler server requests and responses*/
+#define REQUEST_FILE "FILE" /*FILE <name>: assemble <name>.as*/
+#define REQUEST_SOURCE "SOURCE" /*SOURCE <length> <name>: assemble the <length> bytes that follow*/
+#define REQUEST_SHUTDOWN "SHUTDOWN"
+#define RESPONSE_RESULT "RESULT" /*RESULT <success>, followed by sections and END*/
+#define RESPONSE_END "END"
+#define MAX_REQUEST_LINE_LENGTH 4096
+#define MAX_SOURCE_LENGTH 268435456UL /*largest source a SOURCE request may send (256 MB)*/
\ No newline at end of file
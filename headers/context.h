@@ -0,0 +1,55 @@
+#include "libassembler.h"
+
+struct Memory_Image;
+struct Entries_Array;
+struct Symbol_Table;
+struct Macro_Table;
+struct Source_Index;
+struct Arena;
+struct Token_Stream;
+struct Include_Dependencies;
+
+typedef struct Assembler_Context{
+    /*assembler.c*/
+    int lineNumber; /*current line number in source file*/
+    int statementIndent; /*number of whitespace chars before the current statement in its line*/
+    int outputStatus; /*bool that indicates whether to create output files*/
+    int outputExterns; /*bool that indicates whether to create an externals file*/
+    int outputEntries; /*bool that indicates whether to create an entries file*/
+    char* currentFileName; /*name of the file being assembled*/
+    int firstPassJobs; /*number of threads of the first pass, 1 runs the first pass serially*/
+    int binaryObjects; /*bool, secondPass writes a binary object file instead of the .ob, .ext and .ent files*/
+    int crossReference; /*bool, secondPass also writes the cross reference of the labels to the .xref file*/
+
+    /*preProcessor.c*/
+    int preProcessorLineNumber;
+    char* preProcessorFileName;
+    struct Include_Dependencies* includedFiles; /*if not NULL, set to the files the source included, see watch.c*/
+
+    /*statements.c*/
+    int currentInstructionType; /*Instruction_type of the current instruction statement*/
+
+    /*memory.c, labels.c, macros.c*/
+    struct Memory_Image* memory;
+    struct Entries_Array* entries;
+    struct Symbol_Table* symbolTable;
+    struct Macro_Table* macroTable;
+
+    struct Arena* arena; /*short lived strings of the file, see arena.c*/
+
+    struct Token_Stream* tokens; /*tokens of the current statement, see lexer.c*/
+
+    struct Source_Index* sourceIndex; /*lines of the source that the pre processor reads, NULL if not indexed yet*/
+
+    Diagnostics_Sink sink; /*receives all errors and messages of this file*/
+    void* sinkData;
+} Assembler_Context;
+
+
+Assembler_Context* createContext(Diagnostics_Sink sink, void* sinkData);
+void resetContext(Assembler_Context* context);
+void freeContext(Assembler_Context* context);
+void setCurrentContext(Assembler_Context* context);
+Assembler_Context* getCurrentContext();
+void printDiagnosticToStream(void* stream, const char* message);
+void reportDiagnostic(const char* format, ...);
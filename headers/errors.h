@@ -1,28 +1,37 @@
-void raiseFileNotFound(char* filename);
-void raiseExtraMacroTokens(int endMacro);
-void raiseInvalidMacroName(char* str, int operationName);
-void raiseInvalidLabelSyntax(char* str);
-void raiseLabelIsOpName(char* str);
-void raiseLabelIsRegisterName(char* str);
-void raiseLabelAlreadyExists(char* str);
-void raiseCommaAtStart();
-void raiseConsecutiveCommas();
-void raiseCommaAtEnd();
-void raiseNoCommasBetween();
-void raiseInvalidCharInData();
-void raiseStrayTokenError();
-void raiseNoQuotesError();
-void raiseTooManyParams();
-void raiseTooFewParams();
-void raiseNoSpaceAfterOp();
-void raiseMissingOperand();
-void raiseTooManyOperands();
-void raiseInvalidSourceType();
-void raiseInvalidDestinationType();
-void raiseSpaceInJumpOperand();
-void raiseMissingParenthesesInJumpOperand();
-void raiseUndeclaredLabelReference(char* labelName);
-void raiseTooManyParentheses();
-void raiseInvalidEntryLabel(char* labelName);
-void raiseDataOverFlow();
+void raiseFileNotFound(char* filename);
+void raiseExtraMacroTokens(int endMacro);
+void raiseInvalidMacroName(char* str, int operationName);
+void raiseMacroRedefinition(char* str);
+void raiseRecursiveMacro(char* macroName, char* referencedName);
+void raiseMissingMacroName();
+void raiseInvalidMacroParameters(char* macroName);
+void raiseMacroArgumentCount(char* macroName, int parameterCount);
+void raiseInvalidInclude();
+void raiseIncludeNotFound(char* fileName);
+void raiseIncludeCycle(char* fileName);
+void raiseIncludeDepth();
+void raiseInvalidLabelSyntax(char* str);
+void raiseLabelIsOpName(char* str);
+void raiseLabelIsRegisterName(char* str);
+void raiseLabelAlreadyExists(char* str);
+void raiseCommaAtStart();
+void raiseConsecutiveCommas();
+void raiseCommaAtEnd();
+void raiseNoCommasBetween();
+void raiseInvalidCharInData();
+void raiseStrayTokenError();
+void raiseNoQuotesError();
+void raiseTooManyParams();
+void raiseTooFewParams();
+void raiseNoSpaceAfterOp();
+void raiseMissingOperand();
+void raiseTooManyOperands();
+void raiseInvalidSourceType();
+void raiseInvalidDestinationType();
+void raiseSpaceInJumpOperand();
+void raiseMissingParenthesesInJumpOperand();
+void raiseUndeclaredLabelReference(char* labelName, char* lineNumbers);
+void raiseTooManyParentheses();
+void raiseInvalidEntryLabel(char* labelName, int lineNumber);
+void raiseDataOverFlow();
 void raiseUnidentifiedStatement();
\ No newline at end of file
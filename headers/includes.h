@@ -0,0 +1,35 @@
+/*Identity and version of a source file: the device and inode tell which file it is, the modification time and the
+  size tell whether it changed.*/
+typedef struct File_Stamp{
+    unsigned long device;
+    unsigned long inode;
+    long seconds;
+    long nanoseconds;
+    long size;
+} File_Stamp;
+
+/*A file that the output of an include depends on.*/
+typedef struct Include_Dependency{
+    char* fileName; /*without the .as ending*/
+    File_Stamp stamp;
+} Include_Dependency;
+
+typedef struct Include_Dependencies{
+    Include_Dependency* files;
+    int count;
+    int size;
+} Include_Dependencies;
+
+struct Parsed_Include;
+
+char* getIncludedFileName(const char* line, const char* includerFileName);
+int getFileStamp(const char* fileName, File_Stamp* stamp);
+int isSameFile(File_Stamp* first, File_Stamp* second);
+void addIncludeDependency(Include_Dependencies* dependencies, const char* fileName, File_Stamp* stamp);
+void freeIncludeDependencies(Include_Dependencies* dependencies);
+int includeParsed(struct Parsed_Include* include, File_Stamp* includers, int includerCount, Include_Dependencies* dependencies, char** output, size_t* outputLength);
+int includeFromCache(char* fileName, File_Stamp* includers, int includerCount, Include_Dependencies* dependencies, char** output, size_t* outputLength);
+struct Parsed_Include* createParsedInclude(char* fileName, Include_Dependencies* dependencies, const char* output, size_t outputLength);
+void storeParsedInclude(struct Parsed_Include* include);
+void freeParsedInclude(struct Parsed_Include* include);
+void freeIncludeCache();
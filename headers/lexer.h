@@ -0,0 +1,29 @@
+/*The kinds of tokens of a statement.*/
+typedef enum {
+    TOKEN_LABEL, TOKEN_DIRECTIVE, TOKEN_MNEMONIC, TOKEN_REGISTER, TOKEN_IMMEDIATE, TOKEN_NUMBER, TOKEN_IDENTIFIER,
+    TOKEN_STRING, TOKEN_COMMA, TOKEN_OPEN_PARENTHESIS, TOKEN_CLOSE_PARENTHESIS, TOKEN_OTHER
+
+} Token_Type;
+
+/*A token of a statement, a span of the statement that is not copied.*/
+typedef struct Token{
+    Token_Type type;
+    int offset; /*index of the first char of the token in the statement*/
+    int length;
+    int value; /*index of the operation of a mnemonic, number of a register or of an immediate, Instruction_type of a directive*/
+} Token;
+
+/*The tokens of the current statement of a context.*/
+typedef struct Token_Stream{
+    Token* tokens;
+    int tokenCount;
+    int tokensSize;
+    int keyword; /*index of the directive or mnemonic that decides the type of the statement, -1 if there is none*/
+} Token_Stream;
+
+Token_Stream* createTokenStream();
+void freeTokenStream(Token_Stream* tokens);
+Token_Stream* getStatementTokens();
+Token_Stream* lexStatement(char* statement);
+Token* getKeywordToken();
+char* getKeyword(char* statement);
@@ -0,0 +1,38 @@
+#ifndef LIBASSEMBLER_H
+#define LIBASSEMBLER_H
+
+#include <stddef.h>
+
+/*Receives the data pointer given by the caller and a single message (error or notice) of the assembler.*/
+typedef void (*Diagnostics_Sink)(void* sinkData, const char* message);
+
+typedef struct Assembly_Output{
+    int success; /*1 if no errors were found in the source*/
+    char* expandedSource; /*source after the pre processor (contents of the .am file), NULL if the pre processor failed*/
+    size_t expandedSourceLength;
+    char* objects; /*memory image (contents of the .ob file), NULL if there were errors*/
+    size_t objectsLength;
+    char* entries; /*entry labels (contents of the .ent file), NULL if there are none*/
+    size_t entriesLength;
+    char* externs; /*references to external labels (contents of the .ext file), NULL if there are none*/
+    size_t externsLength;
+    char* diagnostics; /*all messages of the assembler, only collected when no sink is given*/
+    size_t diagnosticsLength;
+} Assembly_Output;
+
+/*A session keeps its tables allocated between files, so assembling many files with one session
+  does not go through the full init/free cycle for each file. A session may only be used by one thread at a time.*/
+typedef struct Assembler_Session Assembler_Session;
+
+int assembleSource(const char* name, const char* source, size_t sourceLength,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output);
+void freeAssemblyOutput(Assembly_Output* output);
+
+Assembler_Session* createAssemblerSession();
+int assembleSourceInSession(Assembler_Session* session, const char* name, const char* source, size_t sourceLength,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output);
+int assembleFileInSession(Assembler_Session* session, const char* fileName,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output);
+void freeAssemblerSession(Assembler_Session* session);
+
+#endif
@@ -0,0 +1,31 @@
+#include "libassembler.h"
+
+struct Pre_Processor;
+struct Source_Index;
+
+/*A stream of the lines of the source after the pre processor. The lines are either read from a file or expanded by
+  the pre processor as they are read, see lineStream.c.*/
+typedef struct Line_Stream{
+    FILE* file; /*stream the lines are read from, NULL when they come from an index or the pre processor*/
+    struct Source_Index* source; /*index the lines are read from*/
+    int nextLine; /*number of the next line of source*/
+    char* lineBuffer; /*last line read from file*/
+    size_t lineBufferSize;
+    struct Pre_Processor* preProcessor;
+    FILE* copyFile; /*every expanded line is also written to this stream (the .am file), may be NULL*/
+    const char* pending; /*expanded text that has not been read yet*/
+    size_t pendingLength;
+    int finished; /*bool, the pre processor reached the end of the source or an error*/
+    int succeeded; /*bool, the pre processor reached the end of the source without errors*/
+    Diagnostics_Sink sink; /*sink of the context, messages of the first pass are held back from it*/
+    void* sinkData;
+    char* heldMessages; /*messages of the first pass, each one is terminated by '\0'*/
+    size_t heldLength;
+} Line_Stream;
+
+
+void initFileLineStream(Line_Stream* stream, FILE* file);
+void initSourceLineStream(Line_Stream* stream, struct Source_Index* source);
+void initPreProcessorLineStream(Line_Stream* stream, char* fileName, struct Source_Index* source, FILE* copyFile);
+const char* readStreamLine(Line_Stream* stream, size_t* length);
+int closeLineStream(Line_Stream* stream);
@@ -1,5 +1,15 @@
-void initMacroTable();
-void enterMacro(char* name, char* contents);
-char* getMacroContents(char* name);
-int isValidMacroName(char* str);
+/*Receives the data given to visitMacros and the name, parameter list and body (not terminated) of a macro.*/
+typedef void (*Macro_Visitor)(void* data, char* name, char* parameters, const char* body, size_t bodyLength);
+
+void initMacroTable();
+void beginMacroBody();
+void appendMacroBody(const char* text, size_t length);
+int checkMacroParameters(char* name, char* parameters);
+int enterMacro(char* name, char* parameters);
+int checkMacroCycle(char* name);
+const char* getMacroBody(char* name, size_t* length);
+void visitMacros(Macro_Visitor visitor, void* data);
+int expandMacro(char* line, const char** expansion, size_t* length);
+int isValidMacroName(char* str);
+void resetMacroTable();
 void freeMacroTable();
\ No newline at end of file
@@ -1,17 +1,32 @@
-int isRegisterName(char* str);
-void incrementDataCounter();
-void incrementInstructionCounter();
-void writeToInstructionArray(char* binaryWord);
-void writeToDataArray(char* binaryWord);
-int getIC();
-int getDC();
-void initIC();
-void initDC();
-int getRegisterNumber(char*);
-void encodeLabelsSecondPass();
-int writeMemoryToObjectsFile(char* filename);
-int writeToExternsFile(char* filename);
-int writeToEntriesFile(char* fileName);
-void initEntriesArray();
-void enterEntry(char* name);
+struct Memory_Image;
+
+int isRegisterName(char* str);
+void incrementDataCounter();
+void incrementInstructionCounter();
+void writeToInstructionArray(Machine_Word word);
+void writeFixup(char* labelName, int column);
+void takeFixups(struct Memory_Image* sharedMemory);
+void writeToDataArray(Machine_Word word);
+int getIC();
+int getDC();
+void initIC();
+void initDC();
+void setMemoryCounters(int IC, int DC);
+int getRegisterNumber(char*);
+void encodeLabelsSecondPass();
+int writeMemoryToObjectsFile(FILE* objectsFile);
+int writeToExternsFile(FILE* externsFile);
+int writeToEntriesFile(FILE* entriesFile);
+int writeCrossReferenceFile(FILE* xrefFile);
+int writeToBinaryObjectsFile(FILE* binaryFile);
+void initMemory();
+void shareMemory(struct Memory_Image* sharedMemory);
+void setLargeMemory(int largeMemory);
+int getMemorySize();
+void reserveMemory();
+void resetMemory();
+void freeMemory();
+void initEntriesArray();
+void enterEntry(char* name);
+void resetEntriesArray();
 void freeEntriesArray();
\ No newline at end of file
@@ -1,11 +1,22 @@
-typedef enum {IMMEDIATE, DIRECT, JUMP, DIRECT_REGISTER, NO_TYPE} Assignment_Type;
-
-int isPossibleJumpOperand(char* statement);
-Assignment_Type getAssignmentType(char* operand, int firstJumpCheck);
-int convertOperandToInt(char* operand);
-char* getJumpLabel(char* operand);
-char* getJumpSourceOperand(char* operand);
-char* getJumpDestinationOperand(char* operand);
-char* getSingleOperand(char* pointer);
-char* getSecondOperand(char* pointer);
-char* getJumpOperand(char* pointer);
+typedef enum {IMMEDIATE, DIRECT, JUMP, DIRECT_REGISTER, NO_TYPE} Assignment_Type;
+
+/*An operand of a command, or a part of a jump operand, in a statement.*/
+typedef struct Operand{
+    Assignment_Type type;
+    Text_Span text; /*the operand in the statement*/
+    int value; /*the number of an immediate operand or of a register*/
+} Operand;
+
+/*An operand of a command that is parsed once by parseOperand, for both checking and encoding it.*/
+typedef struct Operand_Descriptor{
+    Operand operand;
+    Operand jumpLabel; /*the label before the parentheses of a jump operand*/
+    Operand jumpSource; /*the operands within the parentheses of a jump operand*/
+    Operand jumpDestination;
+} Operand_Descriptor;
+
+int isPossibleJumpOperand();
+void parseOperand(Text_Span text, Operand_Descriptor* descriptor);
+Text_Span getSingleOperand();
+Text_Span getSecondOperand();
+Text_Span getJumpOperand();
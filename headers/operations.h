@@ -1,15 +1,18 @@
-#include "constants.h"
-
-typedef struct Operation{
-    char opName[5];
-    int opCode; /*The operation code of the operation*/
-    int numberOfOperands;
-} Operation;
-
-
-static const Operation operations[NUMBER_OF_OPERATIONS];
-
-int isOperationName(char* str);
-Operation* getOperation(char* statement);
-int isValidSourceOperand(Operation* operation, char* operand);
-int isValidDestinationOperand(Operation* operation, char* operand);
+#include "constants.h"
+
+struct Operand;
+
+typedef struct Operation{
+    char opName[5];
+    int opCode; /*The operation code of the operation*/
+    int numberOfOperands;
+} Operation;
+
+
+static const Operation operations[NUMBER_OF_OPERATIONS];
+
+int findOperation(char* str);
+int isOperationName(char* str);
+Operation* getOperationByIndex(int index);
+int isValidSourceOperand(Operation* operation, struct Operand* operand);
+int isValidDestinationOperand(Operation* operation, struct Operand* operand);
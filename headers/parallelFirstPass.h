@@ -0,0 +1 @@
+int parallelFirstPass(const char* source, size_t length, int jobCount);
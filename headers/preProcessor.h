@@ -1,3 +1,12 @@
-int preProcessor(char* fileName);
-int getPreProcessorLineNumber();
+struct Pre_Processor;
+struct Source_Index;
+
+int preProcessor(char* fileName);
+int preProcessorFromSource(char* fileName, struct Source_Index* source, FILE* outputFile);
+int preProcessorToFirstPass(char* fileName, int writeExpandedSource);
+struct Pre_Processor* createPreProcessor(char* fileName, struct Source_Index* source);
+const char* expandNextLine(struct Pre_Processor* preProcessor, size_t* length);
+int preProcessorSucceeded(struct Pre_Processor* preProcessor);
+void freePreProcessor(struct Pre_Processor* preProcessor);
+int getPreProcessorLineNumber();
 char* getPreProcessorFileName();
\ No newline at end of file
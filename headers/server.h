@@ -0,0 +1 @@
+int runServer(char* socketPath);
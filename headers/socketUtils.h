@@ -0,0 +1,14 @@
+typedef struct Socket_Reader{
+    int socket;
+    char buffer[BUFSIZ]; /*bytes that have been received but not read yet*/
+    size_t start; /*index of the first unread byte in buffer*/
+    size_t end; /*index after the last received byte in buffer*/
+} Socket_Reader;
+
+void initSocketReader(Socket_Reader* reader, int socket);
+int readSocketLine(Socket_Reader* reader, char* line, int maxLength);
+int readSocketBytes(Socket_Reader* reader, char* buffer, size_t length);
+int writeSocketBytes(int socket, const char* buffer, size_t length);
+int writeSocketSection(int socket, const char* kind, const char* data, size_t length);
+int readSocketSection(Socket_Reader* reader, char* kind, char** data, size_t* length);
+int connectToSocket(char* socketPath);
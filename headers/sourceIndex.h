@@ -0,0 +1,16 @@
+/*The text of a source file and the offset of every line in it, see sourceIndex.c.*/
+typedef struct Source_Index{
+    const char* text;
+    size_t length;
+    size_t* lineStarts; /*offset of every line, followed by length*/
+    int lineCount;
+    size_t mappedLength; /*length of the mapping of the file, 0 if text is not mapped*/
+    char* ownedText; /*text that was read into memory because the file could not be mapped, NULL otherwise*/
+    unsigned long device; /*identity of the file, both are 0 for a source in memory*/
+    unsigned long inode;
+} Source_Index;
+
+Source_Index* openSourceIndex(const char* path);
+Source_Index* createSourceIndex(const char* text, size_t length);
+const char* getSourceLine(Source_Index* index, int lineNumber, size_t* length);
+void freeSourceIndex(Source_Index* index);
@@ -1,21 +1,19 @@
-
-typedef enum {
-    EMPTY, COMMENT, INSTRUCTION, COMMAND, UNIDENTIFIED
-
-} Statement_type;
-
-typedef enum {
-    DATA, STRING, ENTRY, EXTERN, NONE
-
-} Instruction_type;
-
-
-
-Instruction_type getCurrentInstructionType();
-char* getInstruction(char* statement);
-int isPossibleInstructionstatement(char* statement);
-Statement_type getStatementType(char* statement);
-int checkDataInstructionSyntax(char* statement);
-void checkStringInstructionSyntax(char* statement);
-void checkCommandSyntax(char* statement, char* pointer, void* currentOperation);
-void checkJumpOperandSyntax(char* statement, char* pointer); /*DELETE*/
\ No newline at end of file
+
+typedef enum {
+    EMPTY, COMMENT, INSTRUCTION, COMMAND, UNIDENTIFIED
+
+} Statement_type;
+
+typedef enum {
+    DATA, STRING, ENTRY, EXTERN, NONE
+
+} Instruction_type;
+
+
+
+Instruction_type getCurrentInstructionType();
+Statement_type getStatementType(char* statement);
+int checkDataInstructionSyntax(char* statement);
+void checkStringInstructionSyntax(char* statement);
+void checkCommandSyntax(char* statement, char* pointer, void* currentOperation);
+void checkJumpOperandSyntax(); /*DELETE*/
\ No newline at end of file
@@ -1,8 +1,15 @@
-char** splitLineByWhitespace(char* str);
-void trimWhitespace(char* inputStr);
-int checkForExtraCommas(char* statement, char* token);
-int checkForNoCommas(char* pointer);
-int checkForStrayString(char* statement, char* token);
-void checkForValidString(char* string);
-void checkForExtraOperands(char* statement, char* str);
-void checkTooManyParentheses(char* str);
+/*A word of a line, see splitLineSpans.*/
+typedef struct Text_Span{
+    int offset; /*index of the first char of the word in the line*/
+    int length;
+} Text_Span;
+
+char* copyLine(char* buffer, size_t* size, const char* line, size_t length);
+char* copyTrimmedLine(char* buffer, size_t* size, const char* line, size_t* length);
+char* skipLeadingWhitespace(char* str);
+size_t countLeadingWhitespace(const char* line, size_t length);
+int splitLineSpans(const char* line, Text_Span* spans, int maxSpans);
+int isSpanText(const char* line, Text_Span span, const char* text);
+void trimWhitespace(char* inputStr);
+int checkForStrayString(char* statement, char* token);
+void checkForValidString(char* string);
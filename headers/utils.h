@@ -1,10 +1,14 @@
-char* convertToBinary(unsigned int operand, int length);
-void fillBits13to10(char* word, int isJump, int sourceType, int destType);
-void fillBits9to6(char* word, int opCode);
-void fillBits5to4(char* word, int assignmentType, int hasSource);
-void fillBits3to2(char* word, int assignmentType, int hasDest);
-void fillBits1to0(char* word,  int encodingType);
-void fillRegisterWord(char* word, int registerNum, int isSource, int isOnlyOperand, int ARE);
-void fillImmediateNumberWord(char* word, int number, int ARE);
-void encodeLabelAddress(char* word, int labelAddress, int encodingType);
+typedef unsigned int Machine_Word; /*a word of memory, holds wordSize bits (LARGE_WORD_SIZE in large memory mode)*/
+
+void fillBits13to10(Machine_Word* word, int isJump, int sourceType, int destType);
+void fillBits9to6(Machine_Word* word, int opCode);
+void fillBits5to4(Machine_Word* word, int assignmentType, int hasSource);
+void fillBits3to2(Machine_Word* word, int assignmentType, int hasDest);
+void fillBits1to0(Machine_Word* word,  int encodingType);
+void fillRegisterWord(Machine_Word* word, int registerNum, int isSource, int isOnlyOperand, int ARE);
+void fillImmediateNumberWord(Machine_Word* word, int number, int ARE);
+void encodeLabelAddress(Machine_Word* word, int labelAddress, int encodingType, int addressBits);
+Machine_Word convertToWord(int number);
+char* renderWord(Machine_Word word, int width, char* text);
+char* renderDecimal(int number, char* text);
 void deleteOutputFiles(char* filename);
\ No newline at end of file
@@ -0,0 +1,5 @@
+/*Receives the name of a source file (without the .as ending), the stream its messages should be printed to, and an
+  empty list that is set to the files the source included.*/
+typedef void (*Assemble_Function)(char* fileName, FILE* diagnostics, Include_Dependencies* includedFiles);
+
+int watchFiles(char** fileNames, int fileCount, Assemble_Function assemble);
\ No newline at end of file
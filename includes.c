@@ -0,0 +1,313 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "headers/all_headers.h"
+
+
+/*Description: this file contains the include cache. A file that is included (include "name") is pre processed on
+  its own the first time it is included, and its macros and output are kept here for every later file of the batch
+  that includes it, so a shared prologue is only read and pre processed once. An entry is used only while the
+  modification time and the size of every file it was made from are unchanged. The cache is shared by all the
+  threads of a batch (-j N). The server treats every request as a batch of its own and frees the cache after it.*/
+
+
+/*A macro that an included file declares.*/
+typedef struct Included_Macro{
+    char* name;
+    char* parameters;
+    char* body;
+    size_t bodyLength;
+} Included_Macro;
+
+
+typedef struct Parsed_Include{
+    char* fileName; /*without the .as ending*/
+    Include_Dependencies dependencies; /*the file itself followed by every file it includes*/
+    Included_Macro* macros;
+    int macroCount;
+    int macrosSize;
+    char* output; /*the source after the pre processor, not terminated*/
+    size_t outputLength;
+    struct Parsed_Include* next;
+} Parsed_Include;
+
+
+static Parsed_Include* includeCache = NULL;
+static pthread_mutex_t includeCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*Receives a line of a source (with or without leading whitespace) and, if it is an include directive
+  (include "name"), returns the name of the included file without the .as ending (must be freed). A name that is
+  not absolute is relative to the directory of the including file. Returns NULL if the line is not a valid include
+  directive.*/
+char* getIncludedFileName(const char* line, const char* includerFileName){
+    const char* name;
+    const char* end;
+    const char* directoryEnd = strrchr(includerFileName, '/');
+    size_t nameLength, directoryLength;
+    char* fileName;
+
+    while (*line == ' ' || *line == '\t')
+        line++;
+    if (strncmp(line, INCLUDE_ID, strlen(INCLUDE_ID)) != 0)
+        return NULL;
+    line += strlen(INCLUDE_ID);
+    if (*line != ' ' && *line != '\t')
+        return NULL;
+    while (*line == ' ' || *line == '\t')
+        line++;
+    if (*line != '"')
+        return NULL;
+    name = line + 1;
+    end = strchr(name, '"');
+    if (end == NULL || end == name)
+        return NULL;
+    for (line = end + 1; *line != '\0'; line++){
+        if (*line != ' ' && *line != '\t' && *line != '\n' && *line != '\r')
+            return NULL;
+    }
+
+    nameLength = end - name;
+    if (nameLength > strlen(SOURCE_FILETYPE) && strncmp(end - strlen(SOURCE_FILETYPE), SOURCE_FILETYPE, strlen(SOURCE_FILETYPE)) == 0)
+        nameLength -= strlen(SOURCE_FILETYPE);
+    directoryLength = (name[0] == '/' || directoryEnd == NULL) ? 0 : (size_t)(directoryEnd - includerFileName) + 1;
+
+    fileName = malloc(directoryLength + nameLength + 1);
+    memcpy(fileName, includerFileName, directoryLength);
+    memcpy(fileName + directoryLength, name, nameLength);
+    fileName[directoryLength + nameLength] = '\0';
+    return fileName;
+}
+
+
+/*Fills stamp from the status of a file.*/
+static void fillFileStamp(struct stat* status, File_Stamp* stamp){
+    stamp->device = (unsigned long)status->st_dev;
+    stamp->inode = (unsigned long)status->st_ino;
+    stamp->seconds = (long)status->st_mtim.tv_sec;
+    stamp->nanoseconds = (long)status->st_mtim.tv_nsec;
+    stamp->size = (long)status->st_size;
+}
+
+
+/*Receives the name of a source file (without the .as ending) and fills its stamp. Returns 1 if successful, 0 if
+  the file does not exist.*/
+int getFileStamp(const char* fileName, File_Stamp* stamp){
+    struct stat status;
+    char* path = malloc(strlen(fileName) + strlen(SOURCE_FILETYPE) + 1);
+    int result;
+
+    sprintf(path, "%s%s", fileName, SOURCE_FILETYPE);
+    result = stat(path, &status) == 0;
+    free(path);
+    if (result)
+        fillFileStamp(&status, stamp);
+    return result;
+}
+
+
+/*Returns 1 if both stamps belong to the same file, 0 otherwise.*/
+int isSameFile(File_Stamp* first, File_Stamp* second){
+    if (first->inode == 0 || second->inode == 0)
+        return 0;
+    return first->device == second->device && first->inode == second->inode;
+}
+
+
+/*Appends a file to a list of dependencies.*/
+void addIncludeDependency(Include_Dependencies* dependencies, const char* fileName, File_Stamp* stamp){
+    Include_Dependency* dependency;
+    if (dependencies->count == dependencies->size){
+        dependencies->size = dependencies->size == 0 ? 4 : dependencies->size * 2;
+        dependencies->files = realloc(dependencies->files, dependencies->size * sizeof(Include_Dependency));
+    }
+    dependency = &dependencies->files[dependencies->count++];
+    dependency->fileName = malloc(strlen(fileName) + 1);
+    strcpy(dependency->fileName, fileName);
+    dependency->stamp = *stamp;
+}
+
+
+/*Frees the files of a list of dependencies and empties it.*/
+void freeIncludeDependencies(Include_Dependencies* dependencies){
+    int i;
+    for (i=0; i < dependencies->count; i++)
+        free(dependencies->files[i].fileName);
+    free(dependencies->files);
+    dependencies->files = NULL;
+    dependencies->count = 0;
+    dependencies->size = 0;
+}
+
+
+/*Frees an entry of the include cache, or a parsed include that was not stored in it.*/
+void freeParsedInclude(Parsed_Include* include){
+    int i;
+    for (i=0; i < include->macroCount; i++){
+        free(include->macros[i].name);
+        free(include->macros[i].parameters);
+        free(include->macros[i].body);
+    }
+    free(include->macros);
+    freeIncludeDependencies(&include->dependencies);
+    free(include->fileName);
+    free(include->output);
+    free(include);
+}
+
+
+/*Returns the entry of the include cache that was made from the given file, or NULL if there is none.
+  Must be called with includeCacheLock held.*/
+static Parsed_Include** findParsedInclude(char* fileName){
+    Parsed_Include** include = &includeCache;
+    while (*include != NULL && strcmp((*include)->fileName, fileName) != 0)
+        include = &(*include)->next;
+    return include;
+}
+
+
+/*Returns 1 if none of the files an entry was made from changed since, 0 otherwise.*/
+static int isIncludeUpToDate(Parsed_Include* include){
+    File_Stamp stamp;
+    Include_Dependency* dependency;
+    int i;
+    for (i=0; i < include->dependencies.count; i++){
+        dependency = &include->dependencies.files[i];
+        if (!getFileStamp(dependency->fileName, &stamp) || !isSameFile(&stamp, &dependency->stamp)
+            || stamp.seconds != dependency->stamp.seconds || stamp.nanoseconds != dependency->stamp.nanoseconds
+            || stamp.size != dependency->stamp.size)
+            return 0;
+    }
+    return 1;
+}
+
+
+/*Receives a parsed include and the stamps of the files that are including it (the file that contains the directive,
+  the file that includes that file and so on), and includes it: its macros are entered into the macro table, the files
+  it was made from are added to dependencies and output is set to a newly allocated copy of its output (must be
+  freed). Returns 1 if successful and -1 if the file includes one of its includers or declares a macro that is
+  already defined (the error is raised).*/
+int includeParsed(Parsed_Include* include, File_Stamp* includers, int includerCount, Include_Dependencies* dependencies, char** output, size_t* outputLength){
+    Include_Dependency* dependency;
+    Included_Macro* macro;
+    int i, j;
+
+    for (i=0; i < include->dependencies.count; i++){
+        dependency = &include->dependencies.files[i];
+        for (j=0; j < includerCount; j++){
+            if (isSameFile(&dependency->stamp, &includers[j])){
+                raiseIncludeCycle(dependency->fileName);
+                return -1;
+            }
+        }
+    }
+    for (i=0; i < include->macroCount; i++){
+        macro = &include->macros[i];
+        beginMacroBody();
+        appendMacroBody(macro->body, macro->bodyLength);
+        if (!enterMacro(macro->name, macro->parameters)){
+            raiseMacroRedefinition(macro->name);
+            return -1;
+        }
+        if (!checkMacroCycle(macro->name))
+            return -1;
+    }
+    for (i=0; i < include->dependencies.count; i++)
+        addIncludeDependency(dependencies, include->dependencies.files[i].fileName, &include->dependencies.files[i].stamp);
+
+    free(*output);
+    *output = malloc(include->outputLength + 1);
+    memcpy(*output, include->output, include->outputLength);
+    *outputLength = include->outputLength;
+    return 1;
+}
+
+
+/*Receives the name of an included file and the stamps of the files that are including it, and includes the file
+  from the cache, see includeParsed. Returns 0 if the file is not in the cache or changed since it was stored.*/
+int includeFromCache(char* fileName, File_Stamp* includers, int includerCount, Include_Dependencies* dependencies, char** output, size_t* outputLength){
+    Parsed_Include* include;
+    int status;
+
+    pthread_mutex_lock(&includeCacheLock);
+    include = *findParsedInclude(fileName);
+    if (include == NULL || !isIncludeUpToDate(include)){
+        pthread_mutex_unlock(&includeCacheLock);
+        return 0;
+    }
+    status = includeParsed(include, includers, includerCount, dependencies, output, outputLength);
+    pthread_mutex_unlock(&includeCacheLock);
+    return status;
+}
+
+
+/*Macro_Visitor that copies a macro of the macro table into an entry of the include cache.*/
+static void copyIncludedMacro(void* data, char* name, char* parameters, const char* body, size_t bodyLength){
+    Parsed_Include* include = data;
+    Included_Macro* macro;
+    if (include->macroCount == include->macrosSize){
+        include->macrosSize = include->macrosSize == 0 ? 4 : include->macrosSize * 2;
+        include->macros = realloc(include->macros, include->macrosSize * sizeof(Included_Macro));
+    }
+    macro = &include->macros[include->macroCount++];
+    macro->name = malloc(strlen(name) + 1);
+    strcpy(macro->name, name);
+    macro->parameters = malloc(strlen(parameters) + 1);
+    strcpy(macro->parameters, parameters);
+    macro->body = malloc(bodyLength + 1);
+    memcpy(macro->body, body, bodyLength);
+    macro->bodyLength = bodyLength;
+}
+
+
+/*Receives the name of a file that was pre processed on its own, the files it was made from and its output, and
+  returns a parsed include that holds them together with the macros of the current macro table (the macros of the
+  file), see storeParsedInclude.*/
+Parsed_Include* createParsedInclude(char* fileName, Include_Dependencies* dependencies, const char* output, size_t outputLength){
+    Parsed_Include* include = calloc(1, sizeof(Parsed_Include));
+    int i;
+
+    include->fileName = malloc(strlen(fileName) + 1);
+    strcpy(include->fileName, fileName);
+    for (i=0; i < dependencies->count; i++)
+        addIncludeDependency(&include->dependencies, dependencies->files[i].fileName, &dependencies->files[i].stamp);
+    visitMacros(copyIncludedMacro, include);
+    include->output = malloc(outputLength + 1);
+    memcpy(include->output, output, outputLength);
+    include->outputLength = outputLength;
+    return include;
+}
+
+
+/*Stores a parsed include in the include cache, which owns it from now on. An older entry of the same file is
+  replaced.*/
+void storeParsedInclude(Parsed_Include* include){
+    Parsed_Include** slot;
+
+    pthread_mutex_lock(&includeCacheLock);
+    slot = findParsedInclude(include->fileName);
+    if (*slot != NULL){
+        include->next = (*slot)->next;
+        freeParsedInclude(*slot);
+    }
+    *slot = include;
+    pthread_mutex_unlock(&includeCacheLock);
+}
+
+
+/*Frees every entry of the include cache.*/
+void freeIncludeCache(){
+    Parsed_Include* next;
+    pthread_mutex_lock(&includeCacheLock);
+    while (includeCache != NULL){
+        next = includeCache->next;
+        freeParsedInclude(includeCache);
+        includeCache = next;
+    }
+    pthread_mutex_unlock(&includeCacheLock);
+}
@@ -1,245 +1,380 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-
-#include "headers/constants.h"
-#include "headers/operations.h"
-#include "headers/memory.h"
-#include "headers/errors.h"
-#include "headers/stringUtils.h"
-
-
-/*Description: this file contains all functions and data types that have to do with checking, storing, and getting labels 
-  throughout the assembly process.*/
-
-
-static int symbolTableSize; /*holds the max size of the symbol table (dynamically allocated)*/
-static int labelCount; /*current number of labels in symbol table*/
-typedef enum {CODETAG, DATATAG} Label_Tag; /*type of label*/
-typedef enum {ABSOLUTE, EXTERNAL, RELOCATABLE} Encoding_Type; /*encoding type of labels*/
-
-
-typedef struct Label{
-    char* name; /*label name*/
-    int value; /*current IC or DC value (label's address)*/
-    Label_Tag tag; /*code or data*/
-    Encoding_Type type; /*relocatable or external*/
-} Label;
-
-
-static Label** symbolTable; /*Will hold all the labels that are found during the first pass*/
-
-
-/*Initializes symbol table.*/
-void initSymbolTable(){
-    symbolTableSize = INITIAL_TABLE_SIZE;
-    labelCount = 0;
-    symbolTable = malloc(symbolTableSize * sizeof(Label));
-}
-
-
-/*Receives name, value, tag, and type creates a new instance of a Label struct and stores
- it in the symbol table. If the label count is higher than the symbol table size, 
- the symbol table is enlarged dynamically.*/
-void enterSymbol(char* name, int value, Label_Tag tag, Encoding_Type type){
-    Label* currentSymbol;
-    if (labelCount >= symbolTableSize){
-        symbolTableSize += INITIAL_TABLE_SIZE;
-        symbolTable = realloc(symbolTable, symbolTableSize * sizeof(Label));
-    }
-
-    currentSymbol = malloc(sizeof(Label));
-    currentSymbol->name = malloc(MAX_LABEL_LENGTH * sizeof(char));
-
-    strcpy(currentSymbol->name, name);
-    currentSymbol->value = value;
-    currentSymbol->tag = tag;
-    currentSymbol->type = type;
-
-    symbolTable[labelCount] = currentSymbol;
-    labelCount++;
-}
-
-
-/*Receives a string and, if it is the name of an existing label, returns the Label struct.
-  Otherwise returns NULL.*/
-Label* getSymbol(char* name){
-    int i;
-    Label* currentSymbol;
-    for (i=0; i < labelCount; i++){
-        currentSymbol = symbolTable[i];
-        if (strcmp(currentSymbol->name, name) == 0){
-            return currentSymbol;
-        }
-    }
-    return NULL; /*symbol not found*/
-}
-
-/*Receives a value (address) of a label and returns the label with this value. 
-  If none is found, returns NULL.*/
-Label* getSymbolByValue(int value){
-    int i;
-    Label* currentSymbol;
-    for (i=0; i < labelCount; i++){
-        currentSymbol = symbolTable[i];
-        if (currentSymbol->value == value){
-            return currentSymbol;
-        }
-    }
-    return NULL; /*symbol not found*/
-}
-
-
-/*Receives string and, if it is the name of an existing label, returns 1. Otherwise, 
-  returns 0 and raises error.*/
-int checkIfLabelExists(char* name){
-    int i;
-    Label* currentSymbol;
-    for (i=0; i < labelCount; i++){
-        currentSymbol = symbolTable[i];
-        if (strcmp(currentSymbol->name, name) == 0){
-            raiseLabelAlreadyExists(name);
-            return 0;
-        }
-    }
-    return 1;
-}
-
-
-/*Frees symbol table from memory*/
-void freeSymbolTable(){
-    int i;
-    Label* currentSymbol;
-    for (i=0; i < labelCount; i++){
-        currentSymbol = symbolTable[i];
-        free(currentSymbol->name);
-        free(currentSymbol);
-    }
-     free(symbolTable);   
-}
-
-
-/*Adds value of IC to the value of all data labels.*/
-void addICToDataValues(){
-    int i;
-    Label* currentSymbol;
-    for (i=0; i < labelCount; i++){
-        currentSymbol = symbolTable[i];
-        if (currentSymbol->tag == DATATAG)
-            currentSymbol->value += getIC();
-    }
-}
-
-
-/*Checks if label name is a register or operation name. If it is, raises appropriate error and returns
- 0. Otherwise returns 1, meaning it is valid.*/
-int isValidLabelName(char* labelName){
-    int i;
-
-    if (isOperationName(labelName)){
-        raiseLabelIsOpName(labelName);
-        return 0;
-    }
-    if (isRegisterName(labelName)){
-        raiseLabelIsRegisterName(labelName);
-        return 0;
-    }
-
-    if (!isalpha(labelName[0])){ /*First char of label must be alphabetical*/
-        return 0;
-    }
-
-    i = 1;
-    while (i < strlen(labelName)){
-        if (!isalnum(labelName[i])){ /*Label name can only be made up of alphanumeric chars*/
-            return 0;
-        }
-        i++;
-    }
-    
-    return 1;
-}
-
-
-/*Identical to isValidLabelName but does not raise errors. This is used when checking labels 
-  that are operands and not being declared.*/
-int isValidLabelNameNoError(char* labelName){
-    int i;
-
-    if (isOperationName(labelName) || isRegisterName(labelName) || !isalpha(labelName[0])){
-        return 0;
-    }
-
-    i = 1;
-    while (i < strlen(labelName)){
-        if (!isalnum(labelName[i])){ /*Label name can only be made up of alphanumeric chars*/
-            return 0;
-        }
-        i++;
-    }
-
-    return 1;
-}
-
-
-/*Receives a statement from the source file and finds the label name declared in the statement
-  by iterating through the beginning of a statement (label name should be at beginning) until reaching
-  ':' if one exists and returns the label name. If label syntax is invalid, returns NULL.*/
-char* getLabelName(char* statement){
-    int i = 0;
-    char* labelName = malloc(MAX_LABEL_LENGTH + 1);
-    if (isalpha(statement[0])){ /*First char of label must be alphabetical*/
-
-        while (statement[i] != ':'){
-            if (isalnum(statement[i])) /*Label name can only be made up of alphanumeric chars*/
-                labelName[i] = statement[i];
-            else return NULL;
-
-            i++;
-        }
-        labelName[i] = '\0'; /*Terminate label name*/
-    }
-    else return NULL;
-
-    return labelName;
-}
-
-
-/*Receives a statement from the source code and checks if it could be a label declaration by looking for ':' 
-  in the statement. Returns 1 if is a possible label declaration, 0 otherwise.*/
-int isPossibleLabelDeclaration(char* statement){
-    if (strchr(statement, ':') != NULL){
-        /*Found possible label declaration*/
-        return 1;
-    }    
-    return 0;
-}
-
-
-int handleLabelDeclaration(char* statement, Label_Tag tag){
-	char* labelName = getLabelName(statement);
-	if (labelName == NULL){
-		/*this means that the label name either has a space or invalid characters in it*/
-		raiseInvalidLabelSyntax(labelName);
-		return 0;
-	}
-	if (isValidLabelName(labelName) && (checkIfLabelExists(labelName))){
-		/*label name is valid and does not already exist*/
-        if (tag == DATATAG){
-            /*Value is DC for data labels*/
-		    enterSymbol(labelName, getDC(), tag, RELOCATABLE);
-            free(labelName);
-        }
-        if (tag == CODETAG){
-            /*Value is IC for data labels*/
-            enterSymbol(labelName, getIC(), tag, RELOCATABLE);
-            free(labelName);
-        }
-    }
-	else{
-        free(labelName);
-        return 0;
-    }
-	return 1;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "headers/constants.h"
+#include "headers/operations.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/errors.h"
+#include "headers/stringUtils.h"
+#include "headers/context.h"
+#include "headers/arena.h"
+
+
+/*Description: this file contains all functions and data types that have to do with checking, storing, and getting labels 
+  throughout the assembly process.*/
+
+
+typedef enum {CODETAG, DATATAG} Label_Tag; /*type of label*/
+typedef enum {ABSOLUTE, EXTERNAL, RELOCATABLE} Encoding_Type; /*encoding type of labels*/
+
+
+typedef struct Label{
+    char* name; /*label name*/
+    int value; /*current IC or DC value (label's address)*/
+    Label_Tag tag; /*code or data*/
+    Encoding_Type type; /*relocatable or external*/
+    int lineNumber; /*line of the statement that declared the label*/
+} Label;
+
+
+/*A slot of the hash table of the symbol table.*/
+typedef struct Symbol_Slot{
+    unsigned long hash; /*hash of the name of the label, compared before the names are*/
+    int label; /*index of the label in labels plus one, 0 marks an empty slot*/
+} Symbol_Slot;
+
+
+/*An entry of the index of the labels by value.*/
+typedef struct Value_Entry{
+    int value;
+    int label; /*index of the label in labels*/
+} Value_Entry;
+
+
+/*The labels are kept one after the other in a single array, in the order they were entered, and found by name through
+  an open addressing hash table (linear probing) of their indexes, so resolving every word of the second pass does not
+  depend on the number of labels. Lookups by value use an index of the labels sorted by value, which is made again
+  only when a label was entered or the values changed since it was made.
+  The labels returned by getSymbol and getSymbolByValue stay valid until the next label is entered.*/
+typedef struct Symbol_Table{
+    Label* labels;
+    int labelsSize; /*holds the max size of labels (dynamically allocated)*/
+    int labelCount; /*current number of labels in symbol table*/
+    Symbol_Slot* slots;
+    int slotCount; /*always a power of two*/
+    Value_Entry* valueIndex;
+    int valueIndexSize;
+    int valueIndexCount; /*number of labels in valueIndex, -1 if it is out of date*/
+} Symbol_Table;
+
+
+/*Returns the symbol table of the file currently being assembled.*/
+static Symbol_Table* getSymbolTable(){
+    return getCurrentContext()->symbolTable;
+}
+
+
+/*Returns the FNV-1a hash of a label name.*/
+static unsigned long hashLabelName(const char* name){
+    unsigned long hash = 2166136261UL;
+    while (*name){
+        hash = ((hash ^ (unsigned char)*name) * 16777619UL) & 0xffffffffUL;
+        name++;
+    }
+    return hash;
+}
+
+
+/*Returns the slot that holds the label with the given name and hash, or the empty slot it would be entered into.*/
+static Symbol_Slot* findSymbolSlot(Symbol_Table* table, const char* name, unsigned long hash){
+    unsigned long mask = table->slotCount - 1;
+    unsigned long i = hash & mask;
+    while (table->slots[i].label != 0
+        && (table->slots[i].hash != hash || strcmp(table->labels[table->slots[i].label - 1].name, name) != 0))
+        i = (i + 1) & mask;
+    return &table->slots[i];
+}
+
+
+/*Doubles the number of slots of the table and enters all labels into the new slots.*/
+static void growSymbolSlots(Symbol_Table* table){
+    Symbol_Slot* oldSlots = table->slots;
+    int oldSlotCount = table->slotCount;
+    unsigned long mask, j;
+    int i;
+
+    table->slotCount *= 2;
+    table->slots = calloc(table->slotCount, sizeof(Symbol_Slot));
+    mask = table->slotCount - 1;
+    for (i=0; i < oldSlotCount; i++){
+        if (oldSlots[i].label == 0)
+            continue;
+        /*names in the table are unique, the label goes into the first empty slot*/
+        for (j = oldSlots[i].hash & mask; table->slots[j].label != 0; j = (j + 1) & mask)
+            ;
+        table->slots[j] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+
+/*Initializes symbol table of the current context.*/
+void initSymbolTable(){
+    Symbol_Table* table = malloc(sizeof(Symbol_Table));
+    table->labelsSize = INITIAL_TABLE_SIZE;
+    table->labelCount = 0;
+    table->labels = malloc(table->labelsSize * sizeof(Label));
+    table->slotCount = SYMBOL_TABLE_INITIAL_SLOTS;
+    table->slots = calloc(table->slotCount, sizeof(Symbol_Slot));
+    table->valueIndex = NULL;
+    table->valueIndexSize = 0;
+    table->valueIndexCount = -1;
+    getCurrentContext()->symbolTable = table;
+}
+
+
+/*Receives name, value, tag, and type and stores a new label declared at the current line in the symbol table. The
+  labels array and the hash table are enlarged dynamically. If a label with the same name already exists (an external that is declared twice),
+  lookups keep finding the first one.*/
+void enterSymbol(char* name, int value, Label_Tag tag, Encoding_Type type){
+    Label* currentSymbol;
+    Symbol_Slot* slot;
+    Symbol_Table* table = getSymbolTable();
+    unsigned long hash = hashLabelName(name);
+
+    if (table->labelCount >= table->labelsSize){
+        table->labelsSize *= 2;
+        table->labels = realloc(table->labels, table->labelsSize * sizeof(Label));
+    }
+    if ((table->labelCount + 1) * 2 > table->slotCount)
+        growSymbolSlots(table);
+
+    currentSymbol = &table->labels[table->labelCount];
+    currentSymbol->name = internString(name);
+    currentSymbol->value = value;
+    currentSymbol->tag = tag;
+    currentSymbol->type = type;
+    currentSymbol->lineNumber = getCurrentContext()->lineNumber;
+
+    slot = findSymbolSlot(table, name, hash);
+    table->labelCount++;
+    if (slot->label == 0){
+        slot->hash = hash;
+        slot->label = table->labelCount;
+    }
+    table->valueIndexCount = -1;
+}
+
+
+/*Receives a string and, if it is the name of an existing label, returns the Label struct.
+  Otherwise returns NULL.*/
+Label* getSymbol(char* name){
+    Symbol_Table* table = getSymbolTable();
+    Symbol_Slot* slot = findSymbolSlot(table, name, hashLabelName(name));
+    if (slot->label == 0)
+        return NULL; /*symbol not found*/
+    return &table->labels[slot->label - 1];
+}
+
+
+/*Receives an index and returns the label that was entered at this place in the symbol table, in the order the labels
+  were entered. Returns NULL if there are not that many labels.*/
+Label* getSymbolByIndex(int index){
+    Symbol_Table* table = getSymbolTable();
+    if (index < 0 || index >= table->labelCount)
+        return NULL;
+    return &table->labels[index];
+}
+
+
+/*Orders entries of the value index by value, and labels with the same value in the order they were entered.*/
+static int compareValueEntries(const void* first, const void* second){
+    const Value_Entry* firstEntry = first;
+    const Value_Entry* secondEntry = second;
+    if (firstEntry->value != secondEntry->value)
+        return firstEntry->value < secondEntry->value ? -1 : 1;
+    return firstEntry->label - secondEntry->label;
+}
+
+
+/*Makes the index of the labels by value.*/
+static void indexSymbolValues(Symbol_Table* table){
+    int i;
+    if (table->valueIndexSize < table->labelCount){
+        table->valueIndexSize = table->labelsSize;
+        table->valueIndex = realloc(table->valueIndex, table->valueIndexSize * sizeof(Value_Entry));
+    }
+    for (i=0; i < table->labelCount; i++){
+        table->valueIndex[i].value = table->labels[i].value;
+        table->valueIndex[i].label = i;
+    }
+    qsort(table->valueIndex, table->labelCount, sizeof(Value_Entry), compareValueEntries);
+    table->valueIndexCount = table->labelCount;
+}
+
+
+/*Receives a value (address) of a label and returns the label with this value that was entered first.
+  If none is found, returns NULL.*/
+Label* getSymbolByValue(int value){
+    Symbol_Table* table = getSymbolTable();
+    int low = 0, high, middle;
+
+    if (table->valueIndexCount < 0)
+        indexSymbolValues(table);
+    high = table->valueIndexCount;
+    while (low < high){ /*finds the first entry with a value that is not smaller than value*/
+        middle = low + (high - low) / 2;
+        if (table->valueIndex[middle].value < value)
+            low = middle + 1;
+        else high = middle;
+    }
+    if (low == table->valueIndexCount || table->valueIndex[low].value != value)
+        return NULL; /*symbol not found*/
+    return &table->labels[table->valueIndex[low].label];
+}
+
+
+/*Receives string and, if it is the name of an existing label, returns 1. Otherwise, 
+  returns 0 and raises error.*/
+int checkIfLabelExists(char* name){
+    if (getSymbol(name) != NULL){
+        raiseLabelAlreadyExists(name);
+        return 0;
+    }
+    return 1;
+}
+
+
+/*Removes all labels from the symbol table but keeps the table allocated so that it can be
+  reused for the next file.*/
+void resetSymbolTable(){
+    Symbol_Table* table = getSymbolTable();
+    table->labelCount = 0; /*the names are interned in the arena of the file*/
+    memset(table->slots, 0, table->slotCount * sizeof(Symbol_Slot));
+    table->valueIndexCount = -1;
+}
+
+
+/*Frees symbol table from memory*/
+void freeSymbolTable(){
+    Symbol_Table* table = getSymbolTable();
+    resetSymbolTable();
+    free(table->labels);
+    free(table->slots);
+    free(table->valueIndex);
+    free(table);
+    getCurrentContext()->symbolTable = NULL;
+}
+
+
+/*Adds value of IC to the value of all data labels.*/
+void addICToDataValues(){
+    int i;
+    Symbol_Table* table = getSymbolTable();
+    for (i=0; i < table->labelCount; i++){
+        if (table->labels[i].tag == DATATAG)
+            table->labels[i].value += getIC();
+    }
+    table->valueIndexCount = -1;
+}
+
+
+/*Checks if label name is a register or operation name. If it is, raises appropriate error and returns
+ 0. Otherwise returns 1, meaning it is valid.*/
+int isValidLabelName(char* labelName){
+    int i;
+
+    if (isOperationName(labelName)){
+        raiseLabelIsOpName(labelName);
+        return 0;
+    }
+    if (isRegisterName(labelName)){
+        raiseLabelIsRegisterName(labelName);
+        return 0;
+    }
+
+    if (!isalpha(labelName[0])){ /*First char of label must be alphabetical*/
+        return 0;
+    }
+
+    i = 1;
+    while (i < strlen(labelName)){
+        if (!isalnum(labelName[i])){ /*Label name can only be made up of alphanumeric chars*/
+            return 0;
+        }
+        i++;
+    }
+    
+    return 1;
+}
+
+
+/*Identical to isValidLabelName but does not raise errors. This is used when checking labels 
+  that are operands and not being declared.*/
+int isValidLabelNameNoError(char* labelName){
+    int i;
+
+    if (isOperationName(labelName) || isRegisterName(labelName) || !isalpha(labelName[0])){
+        return 0;
+    }
+
+    i = 1;
+    while (i < strlen(labelName)){
+        if (!isalnum(labelName[i])){ /*Label name can only be made up of alphanumeric chars*/
+            return 0;
+        }
+        i++;
+    }
+
+    return 1;
+}
+
+
+/*Receives a statement from the source file and finds the label name declared in the statement
+  by iterating through the beginning of a statement (label name should be at beginning) until reaching
+  ':' if one exists and returns the label name. If label syntax is invalid, returns NULL.*/
+char* getLabelName(char* statement){
+    int i = 0;
+    char* labelName = arenaAlloc(strlen(statement) + 1);
+    if (isalpha(statement[0])){ /*First char of label must be alphabetical*/
+
+        while (statement[i] != ':'){
+            if (isalnum(statement[i])) /*Label name can only be made up of alphanumeric chars*/
+                labelName[i] = statement[i];
+            else return NULL;
+
+            i++;
+        }
+        labelName[i] = '\0'; /*Terminate label name*/
+    }
+    else return NULL;
+
+    return labelName;
+}
+
+
+/*Receives a statement from the source code and checks if it could be a label declaration by looking for ':' 
+  in the statement. Returns 1 if is a possible label declaration, 0 otherwise.*/
+int isPossibleLabelDeclaration(char* statement){
+    if (strchr(statement, ':') != NULL){
+        /*Found possible label declaration*/
+        return 1;
+    }    
+    return 0;
+}
+
+
+int handleLabelDeclaration(char* statement, Label_Tag tag){
+	char* labelName = getLabelName(statement);
+	if (labelName == NULL){
+		/*this means that the label name either has a space or invalid characters in it*/
+		raiseInvalidLabelSyntax(labelName);
+		return 0;
+	}
+	if (isValidLabelName(labelName) && (checkIfLabelExists(labelName))){
+		/*label name is valid and does not already exist*/
+        if (tag == DATATAG){
+            /*Value is DC for data labels*/
+		    enterSymbol(labelName, getDC(), tag, RELOCATABLE);
+        }
+        if (tag == CODETAG){
+            /*Value is IC for data labels*/
+            enterSymbol(labelName, getIC(), tag, RELOCATABLE);
+        }
+    }
+	else return 0;
+	return 1;
+}
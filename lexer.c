@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "headers/constants.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/operations.h"
+#include "headers/statements.h"
+#include "headers/context.h"
+#include "headers/lexer.h"
+
+
+/*Description: this file contains the lexer, which scans a statement once and splits it into typed tokens (label
+  declaration, directive, mnemonic, register, immediate, number, identifier, string, comma and parentheses). A token
+  is a span of the statement (its offset and length), so nothing is copied or allocated. The tokens of the current
+  statement are kept in the context: getStatementType lexes the statement and decides its type by its first directive
+  or mnemonic (its keyword), and the handlers of the first pass find the operation and the operands from the keyword
+  and the tokens after it instead of searching the statement for operation names and operands (see operands.c).*/
+
+
+/*Names of the directives, in the order of Instruction_type.*/
+static const char* directiveNames[] = {".data", ".string", ".entry", ".extern"};
+#define NUMBER_OF_DIRECTIVES 4
+
+
+/*Creates an empty token stream.*/
+Token_Stream* createTokenStream(){
+    Token_Stream* tokens = calloc(1, sizeof(Token_Stream));
+    tokens->tokensSize = INITIAL_TOKENS_SIZE;
+    tokens->tokens = malloc(tokens->tokensSize * sizeof(Token));
+    tokens->keyword = -1;
+    return tokens;
+}
+
+
+/*Frees a token stream.*/
+void freeTokenStream(Token_Stream* tokens){
+    free(tokens->tokens);
+    free(tokens);
+}
+
+
+/*Returns the tokens of the statement that was lexed last in the current context.*/
+Token_Stream* getStatementTokens(){
+    return getCurrentContext()->tokens;
+}
+
+
+/*Receives the start and length of a word that starts with '.' and returns its Instruction_type, NONE if it is not
+  the name of a directive.*/
+static int getDirectiveType(const char* start, int length){
+    int i;
+    for (i=0; i < NUMBER_OF_DIRECTIVES; i++){
+        if ((int)strlen(directiveNames[i]) == length && strncmp(start, directiveNames[i], length) == 0)
+            return i;
+    }
+    return NONE;
+}
+
+
+/*Receives the start and length of an identifier and sets the type of its token: a mnemonic (with the index of its
+  operation), a register (with its number) or any other identifier.*/
+static void classifyIdentifier(Token* token, const char* start, int length){
+    char name[MAX_OPERATION_NAME_LENGTH + 1]; /*long enough for the name of a register too*/
+
+    token->type = TOKEN_IDENTIFIER;
+    if (length > MAX_OPERATION_NAME_LENGTH)
+        return;
+    memcpy(name, start, length);
+    name[length] = '\0';
+    if ((token->value = findOperation(name)) >= 0)
+        token->type = TOKEN_MNEMONIC;
+    else if ((token->value = getRegisterNumber(name)) >= 0)
+        token->type = TOKEN_REGISTER;
+}
+
+
+/*Receives a pointer to a char of a statement and returns a pointer after the letters and digits that start there.*/
+static char* skipWord(char* pointer){
+    while (isalnum((unsigned char)*pointer))
+        pointer++;
+    return pointer;
+}
+
+
+/*Receives a pointer to the opening '"' of a string and returns a pointer after its closing '"'. Like the .string
+  instruction, the string ends at the last '"' of the line, so it may contain '"' itself. If the string is not
+  closed, it ends with the line.*/
+static char* skipString(char* pointer){
+    char* end = NULL; /*after the last '"' of the line*/
+    for (pointer++; *pointer && *pointer != '\n'; pointer++){
+        if (*pointer == '"')
+            end = pointer + 1;
+    }
+    return end != NULL ? end : pointer;
+}
+
+
+/*Appends an empty token to tokens and returns it. The array is enlarged dynamically.*/
+static Token* addToken(Token_Stream* tokens){
+    if (tokens->tokenCount == tokens->tokensSize){
+        tokens->tokensSize *= 2;
+        tokens->tokens = realloc(tokens->tokens, tokens->tokensSize * sizeof(Token));
+    }
+    tokens->tokens[tokens->tokenCount].value = 0;
+    return &tokens->tokens[tokens->tokenCount++];
+}
+
+
+/*Receives the tokens of a statement that is being lexed and returns 1 if a '"' starts a string token, 0 if it is a
+  char of its own. Commands have no string operands, so after the operation name of a command (or a directive other
+  than .string) no token spans whitespace or a comma.*/
+static int isStringAllowed(Token_Stream* tokens){
+    Token* keyword;
+    if (tokens->keyword < 0)
+        return 1;
+    keyword = &tokens->tokens[tokens->keyword];
+    return keyword->type == TOKEN_DIRECTIVE && keyword->value == STRING;
+}
+
+
+/*Receives a statement and splits it into tokens in a single scan. The tokens are kept in the context until the next
+  statement is lexed, and are returned. A word that is immediately followed by ':' at the start of the statement is a
+  label declaration. The keyword of the statement is its first mnemonic or directive that names an instruction. An
+  immediate is '#', an optional sign and digits, any other word that starts with '#' is an other token.*/
+Token_Stream* lexStatement(char* statement){
+    Token_Stream* tokens = getStatementTokens();
+    Token* token;
+    char* pointer = statement;
+    char* start;
+
+    tokens->tokenCount = 0;
+    tokens->keyword = -1;
+    while (*pointer){
+        if (isspace((unsigned char)*pointer)){
+            pointer++;
+            continue;
+        }
+        start = pointer;
+        token = addToken(tokens);
+
+        if (isalpha((unsigned char)*pointer)){
+            pointer = skipWord(pointer);
+            if (*pointer == ':' && tokens->tokenCount == 1){
+                token->type = TOKEN_LABEL;
+                token->offset = start - statement;
+                token->length = pointer - start;
+                pointer++; /*the ':' is part of the declaration*/
+                continue;
+            }
+            classifyIdentifier(token, start, pointer - start);
+        }
+        else if (*pointer == '.'){
+            pointer = skipWord(pointer + 1);
+            token->type = TOKEN_DIRECTIVE;
+            token->value = getDirectiveType(start, pointer - start);
+        }
+        else if (*pointer == '#'){
+            pointer++;
+            if (*pointer == '+' || *pointer == '-')
+                pointer++;
+            while (isdigit((unsigned char)*pointer))
+                pointer++;
+            token->type = isalnum((unsigned char)*pointer) ? TOKEN_OTHER : TOKEN_IMMEDIATE;
+            token->value = atoi(start + 1);
+            pointer = skipWord(pointer);
+        }
+        else if (isdigit((unsigned char)*pointer) || ((*pointer == '+' || *pointer == '-') && isdigit((unsigned char)pointer[1]))){
+            pointer++;
+            while (isdigit((unsigned char)*pointer))
+                pointer++;
+            token->type = TOKEN_NUMBER;
+        }
+        else if (*pointer == '"' && isStringAllowed(tokens)){
+            pointer = skipString(pointer);
+            token->type = TOKEN_STRING;
+        }
+        else {
+            if (*pointer == ',')
+                token->type = TOKEN_COMMA;
+            else if (*pointer == '(')
+                token->type = TOKEN_OPEN_PARENTHESIS;
+            else if (*pointer == ')')
+                token->type = TOKEN_CLOSE_PARENTHESIS;
+            else token->type = TOKEN_OTHER;
+            pointer++;
+        }
+        token->offset = start - statement;
+        token->length = pointer - start;
+
+        if (tokens->keyword < 0 && (token->type == TOKEN_MNEMONIC || (token->type == TOKEN_DIRECTIVE && token->value != NONE)))
+            tokens->keyword = tokens->tokenCount - 1;
+    }
+    return tokens;
+}
+
+
+/*Returns the keyword of the statement that was lexed last, NULL if it has none.*/
+Token* getKeywordToken(){
+    Token_Stream* tokens = getStatementTokens();
+    if (tokens->keyword < 0)
+        return NULL;
+    return &tokens->tokens[tokens->keyword];
+}
+
+
+/*Receives the statement that was lexed last and returns a pointer to its keyword in it, NULL if it has none.*/
+char* getKeyword(char* statement){
+    Token* keyword = getKeywordToken();
+    if (keyword == NULL)
+        return NULL;
+    return statement + keyword->offset;
+}
@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/constants.h"
+#include "headers/assembler.h"
+#include "headers/preProcessor.h"
+#include "headers/sourceIndex.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/labels.h"
+#include "headers/macros.h"
+#include "headers/errors.h"
+#include "headers/context.h"
+#include "headers/lineStream.h"
+
+
+/*Description: this file contains the library interface of the assembler. A source is assembled entirely in memory:
+  the source is given as a buffer and the .am, .ob, .ext and .ent contents are returned as buffers, while all
+  errors are passed to a sink given by the caller. Every call has its own context, so the library can be used
+  from several threads at the same time.*/
+
+
+/*Diagnostics sink that is used when the caller does not give one. Collects the messages into the output.*/
+static void collectDiagnostic(void* outputPointer, const char* message){
+    Assembly_Output* output = outputPointer;
+    size_t length = strlen(message);
+    output->diagnostics = realloc(output->diagnostics, output->diagnosticsLength + length + 1);
+    memcpy(output->diagnostics + output->diagnosticsLength, message, length + 1);
+    output->diagnosticsLength += length;
+}
+
+
+/*Frees an output buffer and resets its length.*/
+static void dropOutputBuffer(char** buffer, size_t* length){
+    free(*buffer);
+    *buffer = NULL;
+    *length = 0;
+}
+
+
+struct Assembler_Session{
+    Assembler_Context* context; /*context whose tables are kept between files*/
+};
+
+
+/*Creates a session with empty tables.*/
+Assembler_Session* createAssemblerSession(){
+    Assembler_Session* session = malloc(sizeof(Assembler_Session));
+    Assembler_Context* previousContext = getCurrentContext();
+
+    session->context = createContext(NULL, NULL);
+    setCurrentContext(session->context);
+    initMacroTable();
+    initSymbolTable();
+    initEntriesArray();
+    initMemory();
+    setCurrentContext(previousContext);
+    return session;
+}
+
+
+/*Frees a session and all of its tables.*/
+void freeAssemblerSession(Assembler_Session* session){
+    Assembler_Context* previousContext = getCurrentContext();
+
+    setCurrentContext(session->context);
+    freeMacroTable();
+    freeSymbolTable();
+    freeEntriesArray();
+    freeMemory();
+    freeContext(session->context);
+    setCurrentContext(previousContext);
+    free(session);
+}
+
+
+/*Prepares the context of a session for a new file: clears the output, resets all tables and sets the sink
+  (or the collecting sink if sink is NULL). Returns the context the calling thread used before.*/
+static Assembler_Context* beginSessionFile(Assembler_Session* session, Diagnostics_Sink sink, void* sinkData, Assembly_Output* output){
+    Assembler_Context* previousContext = getCurrentContext();
+
+    memset(output, 0, sizeof(Assembly_Output));
+    if (sink == NULL){
+        sink = collectDiagnostic;
+        sinkData = output;
+    }
+    resetContext(session->context);
+    session->context->sink = sink;
+    session->context->sinkData = sinkData;
+    setCurrentContext(session->context);
+
+    resetMacroTable();
+    resetSymbolTable();
+    resetEntriesArray();
+    resetMemory();
+    return previousContext;
+}
+
+
+/*Detaches the caller's source and sink from the context of a session and restores the previous context.*/
+static void endSessionFile(Assembler_Session* session, Assembler_Context* previousContext){
+    if (session->context->sourceIndex != NULL)
+        freeSourceIndex(session->context->sourceIndex); /*the index is a view of the caller's source*/
+    session->context->sourceIndex = NULL;
+    session->context->sink = NULL;
+    setCurrentContext(previousContext);
+}
+
+
+/*Receives a session, the name of the source (used in diagnostics), the source code and its length, a diagnostics sink
+  and its data and the output to fill. Resets the tables of the session and runs the pre processor together with the
+  first pass, then the second pass, without reading or writing any file. If sink is NULL, diagnostics are collected into output->diagnostics.
+  Returns 1 if the source was assembled without errors, 0 otherwise.*/
+int assembleSourceInSession(Assembler_Session* session, const char* name, const char* source, size_t sourceLength,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output){
+    Assembler_Context* previousContext = beginSessionFile(session, sink, sinkData, output);
+    Assembler_Context* context = session->context;
+    FILE *expandedFile, *objectsFile, *externsFile, *entriesFile;
+    Line_Stream lines;
+    char* fileName = malloc(strlen(name) + 1);
+    strcpy(fileName, name);
+
+    context->sourceIndex = createSourceIndex(source, sourceLength);
+
+    /*the first pass reads the lines of the pre processor as they are expanded, the expanded source is only a copy*/
+    expandedFile = open_memstream(&output->expandedSource, &output->expandedSourceLength);
+    initPreProcessorLineStream(&lines, fileName, context->sourceIndex, expandedFile);
+    firstPassFromLineStream(fileName, &lines);
+    output->success = closeLineStream(&lines);
+    fclose(expandedFile);
+
+    if (!output->success)
+        /*like the .am file, the expanded source is not kept if the pre processor failed*/
+        dropOutputBuffer(&output->expandedSource, &output->expandedSourceLength);
+
+    if (output->success){
+        /*Only carries out the second pass if pre processor was successful*/
+        objectsFile = open_memstream(&output->objects, &output->objectsLength);
+        externsFile = open_memstream(&output->externs, &output->externsLength);
+        entriesFile = open_memstream(&output->entries, &output->entriesLength);
+        output->success = secondPassToStreams(objectsFile, externsFile, entriesFile);
+        fclose(objectsFile);
+        fclose(externsFile);
+        fclose(entriesFile);
+
+        if (!output->success)
+            dropOutputBuffer(&output->objects, &output->objectsLength);
+        if (!output->success || !context->outputExterns)
+            dropOutputBuffer(&output->externs, &output->externsLength);
+        if (!output->success || !context->outputEntries)
+            dropOutputBuffer(&output->entries, &output->entriesLength);
+    }
+
+    endSessionFile(session, previousContext);
+    free(fileName);
+    return output->success;
+}
+
+
+/*Receives a session and the name of a source file (without the .as ending) and assembles the file in memory
+  with assembleSourceInSession. The output files are not written.*/
+int assembleFileInSession(Assembler_Session* session, const char* fileName,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output){
+    FILE* sourceFile;
+    char* source = NULL;
+    size_t sourceLength = 0;
+    size_t readLength;
+    char buffer[BUFSIZ];
+    char* sourcePath = malloc(strlen(fileName) + strlen(SOURCE_FILETYPE) + 1);
+    int result;
+
+    sprintf(sourcePath, "%s%s", fileName, SOURCE_FILETYPE);
+    sourceFile = fopen(sourcePath, "r");
+    free(sourcePath);
+
+    if (sourceFile == NULL){
+        /*report through the normal error path of the session*/
+        Assembler_Context* previousContext = beginSessionFile(session, sink, sinkData, output);
+        raiseFileNotFound((char*)fileName);
+        endSessionFile(session, previousContext);
+        return 0;
+    }
+
+    while ((readLength = fread(buffer, 1, sizeof(buffer), sourceFile)) > 0){
+        source = realloc(source, sourceLength + readLength);
+        memcpy(source + sourceLength, buffer, readLength);
+        sourceLength += readLength;
+    }
+    fclose(sourceFile);
+
+    result = assembleSourceInSession(session, fileName, source, sourceLength, sink, sinkData, output);
+    free(source);
+    return result;
+}
+
+
+/*Receives the name of the source (used in diagnostics), the source code and its length, a diagnostics sink and its data and
+  the output to fill. Assembles the source with a session of its own, see assembleSourceInSession.*/
+int assembleSource(const char* name, const char* source, size_t sourceLength,
+    Diagnostics_Sink sink, void* sinkData, Assembly_Output* output){
+    Assembler_Session* session = createAssemblerSession();
+    int result = assembleSourceInSession(session, name, source, sourceLength, sink, sinkData, output);
+    freeAssemblerSession(session);
+    return result;
+}
+
+
+/*Frees all buffers of an output that was filled by assembleSource.*/
+void freeAssemblyOutput(Assembly_Output* output){
+    dropOutputBuffer(&output->expandedSource, &output->expandedSourceLength);
+    dropOutputBuffer(&output->objects, &output->objectsLength);
+    dropOutputBuffer(&output->externs, &output->externsLength);
+    dropOutputBuffer(&output->entries, &output->entriesLength);
+    dropOutputBuffer(&output->diagnostics, &output->diagnosticsLength);
+}
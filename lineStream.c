@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/preProcessor.h"
+#include "headers/context.h"
+#include "headers/lineStream.h"
+#include "headers/sourceIndex.h"
+
+
+/*Description: this file contains the line stream the first pass reads its statements from. A line stream either
+  reads a file, or the lines of a source index (the .am file or a source in memory), or runs the pre processor as a
+  producer stage: each time the
+  first pass needs a line, the next line of the source is expanded and handed over without going through a file.
+  The expanded lines can also be copied to a stream, which is how the .am file is written when it is asked for.
+  Since every pre processor error stops the assembly of the file, the messages of the first pass are held back
+  until the pre processor reaches the end of the source, and are dropped if it fails. The messages are printed
+  in the same order as when the first pass ran after the whole source was pre processed.*/
+
+
+/*Diagnostics sink of the first pass while the pre processor has not finished. Keeps the message in the stream.*/
+static void holdDiagnostic(void* streamPointer, const char* message){
+    Line_Stream* stream = streamPointer;
+    size_t length = strlen(message) + 1;
+    stream->heldMessages = realloc(stream->heldMessages, stream->heldLength + length);
+    memcpy(stream->heldMessages + stream->heldLength, message, length);
+    stream->heldLength += length;
+}
+
+
+/*Gives the messages of the first pass back to the sink of the context, which is the original sink again.
+  The messages are only reported if the pre processor succeeded.*/
+static void releaseHeldMessages(Line_Stream* stream){
+    Assembler_Context* context = getCurrentContext();
+    size_t position = 0;
+
+    context->sink = stream->sink;
+    context->sinkData = stream->sinkData;
+    while (stream->succeeded && position < stream->heldLength){
+        reportDiagnostic("%s", stream->heldMessages + position);
+        position += strlen(stream->heldMessages + position) + 1;
+    }
+    free(stream->heldMessages);
+    stream->heldMessages = NULL;
+    stream->heldLength = 0;
+}
+
+
+/*Runs the pre processor on the next line of the source and makes the text it expands to the pending text of the
+  stream. Messages of the pre processor go straight to the original sink. Returns 0 when the pre processor has
+  finished, 1 otherwise.*/
+static int pullExpandedText(Line_Stream* stream){
+    Assembler_Context* context = getCurrentContext();
+    const char* text;
+    size_t length;
+
+    context->sink = stream->sink;
+    context->sinkData = stream->sinkData;
+    text = expandNextLine(stream->preProcessor, &length);
+    if (text == NULL){
+        stream->finished = 1;
+        stream->succeeded = preProcessorSucceeded(stream->preProcessor);
+        releaseHeldMessages(stream);
+        stream->pendingLength = 0;
+        return 0;
+    }
+
+    context->sink = holdDiagnostic;
+    context->sinkData = stream;
+    if (stream->copyFile != NULL)
+        fwrite(text, 1, length, stream->copyFile);
+    stream->pending = text;
+    stream->pendingLength = length;
+    return 1;
+}
+
+
+/*Creates a line stream that reads the lines of a file.*/
+void initFileLineStream(Line_Stream* stream, FILE* file){
+    memset(stream, 0, sizeof(Line_Stream));
+    stream->file = file;
+    stream->finished = 1;
+    stream->succeeded = 1;
+}
+
+
+/*Creates a line stream that reads the lines of a source index.*/
+void initSourceLineStream(Line_Stream* stream, Source_Index* source){
+    memset(stream, 0, sizeof(Line_Stream));
+    stream->source = source;
+    stream->finished = 1;
+    stream->succeeded = 1;
+}
+
+
+/*Creates a line stream that runs the pre processor on the given source as its lines are read.
+  Every expanded line is also written to copyFile, unless it is NULL.*/
+void initPreProcessorLineStream(Line_Stream* stream, char* fileName, Source_Index* source, FILE* copyFile){
+    Assembler_Context* context = getCurrentContext();
+
+    memset(stream, 0, sizeof(Line_Stream));
+    stream->preProcessor = createPreProcessor(fileName, source);
+    stream->copyFile = copyFile;
+    stream->sink = context->sink;
+    stream->sinkData = context->sinkData;
+    context->sink = holdDiagnostic;
+    context->sinkData = stream;
+}
+
+
+/*Returns the next line of the stream, of any length, and sets length to its length (including the '\n', unless it
+  is the last line of a source that does not end with one). The line is not terminated and is a view of the text of
+  the file, the index or the pre processor, which stays valid until the next line is read. Returns NULL at the end
+  of the stream.*/
+const char* readStreamLine(Line_Stream* stream, size_t* length){
+    const char* line;
+    const char* newLine;
+    ssize_t readLength;
+
+    if (stream->file != NULL){
+        readLength = getline(&stream->lineBuffer, &stream->lineBufferSize, stream->file);
+        if (readLength < 0)
+            return NULL;
+        *length = readLength;
+        return stream->lineBuffer;
+    }
+    if (stream->source != NULL)
+        return getSourceLine(stream->source, stream->nextLine++, length);
+
+    while (stream->pendingLength == 0){
+        /*all of the current text was read, expand the next line of the source*/
+        if (stream->finished || !pullExpandedText(stream))
+            return NULL;
+    }
+    /*the pending text may hold several lines (the expansion of a macro)*/
+    line = stream->pending;
+    newLine = memchr(line, '\n', stream->pendingLength);
+    *length = newLine == NULL ? stream->pendingLength : (size_t)(newLine - line) + 1;
+    stream->pending += *length;
+    stream->pendingLength -= *length;
+    return line;
+}
+
+
+/*Finishes a line stream. The rest of the source goes through the pre processor, so all of its errors are reported and
+  the copy is complete even if not every line was read. Returns 1 if the lines of the stream are the whole output of
+  a successful pre processor (always 1 for a file), 0 if the pre processor failed and the first pass should be ignored.*/
+int closeLineStream(Line_Stream* stream){
+    int succeeded;
+
+    while (!stream->finished)
+        pullExpandedText(stream);
+    succeeded = stream->succeeded;
+    if (stream->preProcessor != NULL)
+        freePreProcessor(stream->preProcessor);
+    free(stream->lineBuffer);
+    memset(stream, 0, sizeof(Line_Stream));
+    return succeeded;
+}
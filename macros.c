@@ -1,86 +1,635 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-#include "headers\\all_headers.h"
-
-
-static int macroTableSize;
-static int macroCount;
-
-
-typedef struct Macro{
-    char* name;
-    char* contents;
-} Macro;
-
-static Macro** macroTable; /*Will hold the name and contents of each macro that is found in pre processor stage*/
-
-
-/*Initializes macroTable.*/
-void initMacroTable(){
-    macroTableSize = INITIAL_TABLE_SIZE;
-    macroCount = 0;
-    macroTable = malloc(macroTableSize * sizeof(Macro));
-}
-
-
-
-/*Receives a macro name and its contents and enters them as a Macro struct into the next available space in the macroTable.*/
-void enterMacro(char* name, char* contents){
-    Macro* currentMacro;
-    if (macroCount >= macroTableSize){
-        macroTableSize += INITIAL_TABLE_SIZE;
-        macroTable = realloc(macroTable, macroTableSize * sizeof(Macro));
-    }
-
-    currentMacro = malloc(sizeof(Macro));
-    currentMacro->name = malloc(strlen(name) * sizeof(char) + 1);
-    currentMacro->contents = malloc(strlen(contents) * sizeof(char) + 1);
-
-    strcpy(currentMacro->name, name);
-    strcpy(currentMacro->contents, contents);
-
-    macroTable[macroCount] = currentMacro;
-    macroCount++;
-}
-
-
-/*Receives a string and, if it is the name of an existing macro, returns its contents.*/
-char* getMacroContents(char* name){
-    int i;
-    Macro* currentMacro;
-    for (i=0; i < macroCount; i++){
-        currentMacro = macroTable[i];
-        if (strcmp(currentMacro->name, name) == 0)
-            return currentMacro->contents;
-    }
-    return NULL;
-}
-
-/*Frees macro table from memory*/
-void freeMacroTable(){
-    int i;
-    Macro* currentMacro;
-    for (i=0; i < macroCount; i++){
-        currentMacro = macroTable[i];
-        free(currentMacro->name);
-        free(currentMacro->contents);
-        free(currentMacro);
-    }
-    free(macroTable);
-}
-
-
-/*Receives string which is supposed to be a macro name. Returns 1 if the name is valid, 0 otherwise.*/
-int isValidMacroName(char* str){
-    if (isOperationName(str)){
-        raiseInvalidMacroName(str, 1);
-        return 0;
-    }
-    if (isRegisterName(str)){
-        raiseInvalidMacroName(str, 0);
-        return 0;
-    }
-    return 1;
-}
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "headers/all_headers.h"
+
+
+typedef enum {NOT_EXPANDED, EXPANDING, EXPANDED} Expansion_State;
+
+
+/*A piece of the template of a macro: either a span of its body or one of its parameters.*/
+typedef struct Template_Piece{
+    int parameter; /*index of the parameter, or -1 if the piece is bodies[start...start+length-1]*/
+    size_t start;
+    size_t length;
+} Template_Piece;
+
+
+typedef struct Macro{
+    char* name;
+    size_t bodyStart; /*the body of the macro is bodies[bodyStart...bodyStart+bodyLength-1] of the macro table*/
+    size_t bodyLength;
+    char* parameters; /*the parameter list of the declaration*/
+    int parameterCount;
+    Template_Piece* pieces; /*the body split at every parameter, no piece spans two lines*/
+    int pieceCount;
+    Expansion_State expansionState;
+    int expansionGeneration; /*number of macros in the table when the expansion was made*/
+    int expansionInBodies; /*bool, the body has no references to other macros and is its own expansion*/
+    size_t expansionStart; /*start of the expansion in bodies or in expansions of the macro table*/
+    size_t expansionLength;
+    int cycleCheck; /*number of the last checkMacroCycle that visited the macro*/
+} Macro;
+
+
+typedef struct Text_Buffer{
+    char* text;
+    size_t length;
+    size_t size;
+} Text_Buffer;
+
+
+/*A span of text, an argument of a macro reference or the name of a parameter.*/
+typedef struct Macro_Argument{
+    const char* text;
+    size_t length;
+} Macro_Argument;
+
+
+/*The macros are kept in an open addressing hash table (linear probing), so looking up the first token of every
+  line does not depend on the number of macros. The bodies of all macros are kept one after the other in a single
+  append only buffer: the lines of a body are appended while it is being declared and each macro only holds the
+  span of its body, so capturing a body and expanding it are linear in its length.
+  When a macro is entered its body is compiled into a template, the spans of the body between the places its
+  parameters appear in, so a reference with arguments is expanded by splicing the arguments between the spans.
+  A line of a body whose first token is the name of a macro is replaced by the expansion of that macro. The expansion
+  of every macro without parameters is made once, in a second append only buffer, and reused by every later
+  reference. It is made again only if macros were entered since, because a reference that was not a macro name may
+  have become one. Expansions of macros with parameters depend on the arguments and are made in instance.*/
+typedef struct Macro_Table{
+    Macro** slots; /*NULL marks an empty slot*/
+    int slotCount; /*always a power of two*/
+    int macroCount;
+    Text_Buffer bodies;
+    size_t openBodyStart; /*start of the body that is being declared, everything after it is not entered yet*/
+    Text_Buffer expansions;
+    Text_Buffer instance; /*expansion of the last reference to a macro with parameters*/
+    int cycleChecks; /*number of calls to checkMacroCycle*/
+} Macro_Table;
+
+
+/*Returns the macro table of the file currently being assembled.*/
+static Macro_Table* getMacroTable(){
+    return getCurrentContext()->macroTable;
+}
+
+
+/*Returns the FNV-1a hash of a macro name of the given length.*/
+static unsigned long hashMacroName(const char* name, size_t length){
+    unsigned long hash = 2166136261UL;
+    size_t i;
+    for (i=0; i < length; i++)
+        hash = ((hash ^ (unsigned char)name[i]) * 16777619UL) & 0xffffffffUL;
+    return hash;
+}
+
+
+/*Returns the slot that holds the macro whose name is the given span (which does not have to be terminated), or the
+  empty slot it would be entered into.*/
+static Macro** findMacroSlot(Macro_Table* table, const char* name, size_t length){
+    unsigned long mask = table->slotCount - 1;
+    unsigned long i = hashMacroName(name, length) & mask;
+    while (table->slots[i] != NULL && (strncmp(table->slots[i]->name, name, length) != 0 || table->slots[i]->name[length] != '\0'))
+        i = (i + 1) & mask;
+    return &table->slots[i];
+}
+
+
+/*Doubles the number of slots of the table and enters all macros into the new slots.*/
+static void growMacroTable(Macro_Table* table){
+    Macro** oldSlots = table->slots;
+    int oldSlotCount = table->slotCount;
+    int i;
+
+    table->slotCount *= 2;
+    table->slots = calloc(table->slotCount, sizeof(Macro*));
+    for (i=0; i < oldSlotCount; i++){
+        if (oldSlots[i] != NULL)
+            *findMacroSlot(table, oldSlots[i]->name, strlen(oldSlots[i]->name)) = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+
+/*Appends text of the given length to the end of buffer. text must not be in buffer.*/
+static void appendText(Text_Buffer* buffer, const char* text, size_t length){
+    if (buffer->length + length > buffer->size){
+        if (buffer->size == 0)
+            buffer->size = MACRO_BODIES_INITIAL_SIZE;
+        while (buffer->length + length > buffer->size)
+            buffer->size *= 2;
+        buffer->text = realloc(buffer->text, buffer->size);
+    }
+    memcpy(buffer->text + buffer->length, text, length);
+    buffer->length += length;
+}
+
+
+/*Initializes macroTable of the current context.*/
+void initMacroTable(){
+    Macro_Table* table = malloc(sizeof(Macro_Table));
+    table->slotCount = MACRO_TABLE_INITIAL_SLOTS;
+    table->macroCount = 0;
+    table->slots = calloc(table->slotCount, sizeof(Macro*));
+    table->bodies.size = MACRO_BODIES_INITIAL_SIZE;
+    table->bodies.text = malloc(table->bodies.size);
+    table->bodies.length = 0;
+    table->openBodyStart = 0;
+    table->expansions.size = MACRO_BODIES_INITIAL_SIZE;
+    table->expansions.text = malloc(table->expansions.size);
+    table->expansions.length = 0;
+    table->instance.text = NULL;
+    table->instance.length = 0;
+    table->instance.size = 0;
+    table->cycleChecks = 0;
+    getCurrentContext()->macroTable = table;
+}
+
+
+
+/*Starts the body of a new macro. Text appended to a body that was not entered is dropped.*/
+void beginMacroBody(){
+    Macro_Table* table = getMacroTable();
+    table->bodies.length = table->openBodyStart;
+}
+
+
+/*Receives text (a line of a macro declaration) and its length and appends it to the body that is being declared.*/
+void appendMacroBody(const char* text, size_t length){
+    appendText(&getMacroTable()->bodies, text, length);
+}
+
+
+/*Returns 1 if the character may be part of a macro parameter name, 0 otherwise.*/
+static int isParameterCharacter(char c){
+    return isalnum((unsigned char)c);
+}
+
+
+/*Receives text and its length and splits it at every comma into arguments, trimmed of whitespace. Returns the
+  number of arguments (0 if the text is only whitespace), of which at most maxArguments are stored, or -1 if one
+  of the arguments is empty.*/
+static int splitMacroArguments(const char* text, size_t length, Macro_Argument* arguments, int maxArguments){
+    size_t position = 0, end;
+    int count = 0;
+
+    while (position < length && isspace((unsigned char)text[position]))
+        position++;
+    if (position == length)
+        return 0;
+
+    while (1){
+        while (position < length && isspace((unsigned char)text[position]))
+            position++;
+        end = position;
+        while (end < length && text[end] != ',')
+            end++;
+        if (count < maxArguments){
+            arguments[count].text = text + position;
+            arguments[count].length = end - position;
+            while (arguments[count].length > 0 && isspace((unsigned char)text[position + arguments[count].length - 1]))
+                arguments[count].length--;
+            if (arguments[count].length == 0)
+                return -1;
+        }
+        count++;
+        if (end == length)
+            return count;
+        position = end + 1;
+    }
+}
+
+
+/*Receives a parameter name and returns 1 if it is the name of an operation or a register, which a parameter would
+  replace in the body, 0 otherwise.*/
+static int isReservedParameterName(Macro_Argument* name){
+    char copy[MAX_OPERATION_NAME_LENGTH + 1]; /*long enough for the name of a register too*/
+    if (name->length > MAX_OPERATION_NAME_LENGTH)
+        return 0;
+    memcpy(copy, name->text, name->length);
+    copy[name->length] = '\0';
+    return isOperationName(copy) || isRegisterName(copy);
+}
+
+
+/*Receives the name of a macro and the text that follows it in its declaration and checks that the text is a list of
+  at most MAX_MACRO_PARAMETERS different parameter names separated by commas (or that it is empty). Like the name of
+  a macro, a parameter name may not be the name of an operation or a register.
+  Returns 1 if it is, 0 otherwise (after raising an error).*/
+int checkMacroParameters(char* name, char* parameters){
+    Macro_Argument names[MAX_MACRO_PARAMETERS];
+    int count = splitMacroArguments(parameters, strlen(parameters), names, MAX_MACRO_PARAMETERS);
+    int i, j;
+    size_t k;
+
+    if (count < 0 || count > MAX_MACRO_PARAMETERS){
+        raiseInvalidMacroParameters(name);
+        return 0;
+    }
+    for (i=0; i < count; i++){
+        if (!isalpha((unsigned char)names[i].text[0]) || isReservedParameterName(&names[i])){
+            raiseInvalidMacroParameters(name);
+            return 0;
+        }
+        for (k=1; k < names[i].length; k++){
+            if (!isParameterCharacter(names[i].text[k])){
+                raiseInvalidMacroParameters(name);
+                return 0;
+            }
+        }
+        for (j=0; j < i; j++){
+            if (names[j].length == names[i].length && memcmp(names[j].text, names[i].text, names[i].length) == 0){
+                raiseInvalidMacroParameters(name);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+
+/*Appends a piece to the template of macro.*/
+static void addTemplatePiece(Macro* macro, int* piecesSize, int parameter, size_t start, size_t length){
+    if (macro->pieceCount == *piecesSize){
+        *piecesSize = *piecesSize == 0 ? 4 : *piecesSize * 2;
+        macro->pieces = realloc(macro->pieces, *piecesSize * sizeof(Template_Piece));
+    }
+    macro->pieces[macro->pieceCount].parameter = parameter;
+    macro->pieces[macro->pieceCount].start = start;
+    macro->pieces[macro->pieceCount].length = length;
+    macro->pieceCount++;
+}
+
+
+/*Compiles the body of macro into its template. Every word of the body (a letter followed by letters and digits)
+  that is the name of one of the parameters becomes a parameter piece and the text between them becomes spans of
+  the body, split at the end of every line. Words in quoted text and after a ';' are left as they are.
+  parameters is the checked list of parameter names.*/
+static void compileTemplate(Macro_Table* table, Macro* macro, char* parameters){
+    Macro_Argument names[MAX_MACRO_PARAMETERS];
+    const char* body = table->bodies.text;
+    size_t end = macro->bodyStart + macro->bodyLength;
+    size_t position = macro->bodyStart, literalStart = macro->bodyStart, wordEnd;
+    int piecesSize = 0, i, parameter;
+    int inString = 0, inComment = 0; /*bools, the position is in quoted text or after a ';' of its line*/
+
+    macro->parameterCount = splitMacroArguments(parameters, strlen(parameters), names, MAX_MACRO_PARAMETERS);
+    macro->pieces = NULL;
+    macro->pieceCount = 0;
+
+    while (position < end){
+        if (body[position] == '\n'){
+            addTemplatePiece(macro, &piecesSize, -1, literalStart, position + 1 - literalStart);
+            literalStart = ++position;
+            inString = inComment = 0;
+            continue;
+        }
+        if (body[position] == '"' && !inComment)
+            inString = !inString;
+        else if (body[position] == ';' && !inString)
+            inComment = 1;
+        if (macro->parameterCount == 0 || inString || inComment || !isalpha((unsigned char)body[position])
+            || (position > macro->bodyStart && isParameterCharacter(body[position - 1]))){
+            position++;
+            continue;
+        }
+        /*start of a word, which may be a parameter*/
+        wordEnd = position;
+        while (wordEnd < end && isParameterCharacter(body[wordEnd]))
+            wordEnd++;
+        parameter = -1;
+        for (i=0; i < macro->parameterCount && parameter < 0; i++){
+            if (names[i].length == wordEnd - position && memcmp(names[i].text, body + position, names[i].length) == 0)
+                parameter = i;
+        }
+        if (parameter >= 0){
+            if (position > literalStart)
+                addTemplatePiece(macro, &piecesSize, -1, literalStart, position - literalStart);
+            addTemplatePiece(macro, &piecesSize, parameter, 0, 0);
+            literalStart = wordEnd;
+        }
+        position = wordEnd;
+    }
+    if (literalStart < end)
+        addTemplatePiece(macro, &piecesSize, -1, literalStart, end - literalStart);
+}
+
+
+/*Receives a macro name and the list of its parameters (checked by checkMacroParameters) and enters it into the
+  macroTable with the body that was appended since beginMacroBody, compiled into a template.
+  Returns 1 if successful, 0 if a macro with the same name is already defined (the body is dropped).*/
+int enterMacro(char* name, char* parameters){
+    Macro* currentMacro;
+    Macro** slot;
+    Macro_Table* table = getMacroTable();
+
+    if ((table->macroCount + 1) * 4 > table->slotCount * 3)
+        /*keeps the table at most 3/4 full so the probe sequences stay short*/
+        growMacroTable(table);
+
+    slot = findMacroSlot(table, name, strlen(name));
+    if (*slot != NULL){
+        table->bodies.length = table->openBodyStart;
+        return 0;
+    }
+
+    currentMacro = malloc(sizeof(Macro));
+    currentMacro->name = malloc(strlen(name) * sizeof(char) + 1);
+    strcpy(currentMacro->name, name);
+    currentMacro->parameters = malloc(strlen(parameters) * sizeof(char) + 1);
+    strcpy(currentMacro->parameters, parameters);
+    currentMacro->expansionState = NOT_EXPANDED;
+    currentMacro->cycleCheck = 0;
+    currentMacro->bodyStart = table->openBodyStart;
+    currentMacro->bodyLength = table->bodies.length - table->openBodyStart;
+    table->openBodyStart = table->bodies.length;
+    compileTemplate(table, currentMacro, parameters);
+
+    *slot = currentMacro;
+    table->macroCount++;
+    return 1;
+}
+
+
+/*Receives a string and, if it is the name of an existing macro, returns its body and sets length to the length
+  of the body. The body is not terminated and stays valid until the next macro body is appended.*/
+const char* getMacroBody(char* name, size_t* length){
+    Macro_Table* table = getMacroTable();
+    Macro* currentMacro = *findMacroSlot(table, name, strlen(name));
+    if (currentMacro == NULL)
+        return NULL;
+    *length = currentMacro->bodyLength;
+    return table->bodies.text + currentMacro->bodyStart;
+}
+
+
+/*Calls visitor with the name, parameter list and body of every macro in the table.*/
+void visitMacros(Macro_Visitor visitor, void* data){
+    Macro_Table* table = getMacroTable();
+    int i;
+    for (i=0; i < table->slotCount; i++){
+        if (table->slots[i] != NULL)
+            visitor(data, table->slots[i]->name, table->slots[i]->parameters,
+                table->bodies.text + table->slots[i]->bodyStart, table->slots[i]->bodyLength);
+    }
+}
+
+
+/*Receives a line and its length and returns the macro that the first token of the line refers to, or NULL if it
+  is not the name of a macro. tokenLength is set to the length of the first token.*/
+static Macro* getReferencedMacro(Macro_Table* table, const char* line, size_t lineLength, size_t* tokenLength){
+    size_t length = 0;
+    while (length < lineLength && line[length] != ' ' && line[length] != '\t' && line[length] != '\n')
+        length++;
+    *tokenLength = length;
+    return *findMacroSlot(table, line, length);
+}
+
+
+/*Returns 1 if the piece of the template of macro at the given index starts a line, 0 otherwise.*/
+static int isLineStart(Macro_Table* table, Macro* macro, int piece){
+    Template_Piece* previous;
+    if (piece == 0)
+        return 1;
+    previous = &macro->pieces[piece - 1];
+    return previous->parameter < 0 && table->bodies.text[previous->start + previous->length - 1] == '\n';
+}
+
+
+/*Receives a macro and the index of a piece of its template that starts a line and returns the macro that the line
+  refers to whatever the arguments are. Returns NULL if the line does not refer to a macro, or if its first token is
+  made of arguments, which is checked when the macro is expanded.*/
+static Macro* getLineReference(Macro_Table* table, Macro* macro, int piece){
+    Template_Piece* start = &macro->pieces[piece];
+    Macro* referenced;
+    size_t tokenLength;
+
+    if (start->parameter >= 0)
+        return NULL;
+    referenced = getReferencedMacro(table, table->bodies.text + start->start, start->length, &tokenLength);
+    if (tokenLength == start->length && piece + 1 < macro->pieceCount)
+        return NULL; /*the token goes on with an argument*/
+    return referenced;
+}
+
+
+/*Returns 1 if macro refers to target, directly or through other macros, 0 otherwise. Macros that were visited by the
+  same check are not visited again.*/
+static int refersToMacro(Macro_Table* table, Macro* macro, Macro* target){
+    Macro* referenced;
+    int i;
+
+    macro->cycleCheck = table->cycleChecks;
+    for (i=0; i < macro->pieceCount; i++){
+        if (!isLineStart(table, macro, i))
+            continue;
+        referenced = getLineReference(table, macro, i);
+        if (referenced == target)
+            return 1;
+        if (referenced != NULL && referenced->cycleCheck != table->cycleChecks && refersToMacro(table, referenced, target))
+            return 1;
+    }
+    return 0;
+}
+
+
+/*Receives the name of a macro that was just entered and checks that it does not refer to itself, directly or through
+  other macros, so a recursive macro is reported where it is declared even if it is never referenced. Only a new macro
+  can close a cycle, so checking every macro as it is entered finds all of them, apart from references that are made
+  of arguments, which expandMacro reports. Returns 1 if there is no cycle, 0 otherwise (after raising an error).*/
+int checkMacroCycle(char* name){
+    Macro_Table* table = getMacroTable();
+    Macro* macro = *findMacroSlot(table, name, strlen(name));
+    Macro* referenced;
+    int i;
+
+    if (macro == NULL)
+        return 1;
+    table->cycleChecks++;
+    macro->cycleCheck = table->cycleChecks;
+    for (i=0; i < macro->pieceCount; i++){
+        if (!isLineStart(table, macro, i))
+            continue;
+        referenced = getLineReference(table, macro, i);
+        if (referenced != NULL && (referenced == macro || refersToMacro(table, referenced, macro))){
+            raiseRecursiveMacro(macro->name, referenced->name);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*Receives the text that follows a reference to macro in a line (without the '\n') and splits it into arguments.
+  Returns 1 if they match the parameters of the macro, 0 otherwise (after raising an error). Text that follows a
+  reference to a macro without parameters is ignored.*/
+static int getMacroArguments(Macro* macro, const char* text, size_t length, Macro_Argument* arguments){
+    int count;
+    if (macro->parameterCount == 0)
+        return 1;
+    count = splitMacroArguments(text, length, arguments, MAX_MACRO_PARAMETERS);
+    if (count != macro->parameterCount){
+        raiseMacroArgumentCount(macro->name, macro->parameterCount);
+        return 0;
+    }
+    return 1;
+}
+
+
+/*Returns the expansion of a macro without parameters that is up to date.*/
+static const char* getExpansionText(Macro_Table* table, Macro* macro){
+    return (macro->expansionInBodies ? table->bodies.text : table->expansions.text) + macro->expansionStart;
+}
+
+
+/*Makes the expansion of macro, with its parameters replaced by arguments, and appends it to output (unless output is
+  NULL). The expansion of a macro without parameters is kept in the table and only made again if it is out of date.
+  Every line whose first token is the name of a macro is replaced by the expansion of that macro. Returns 1 if
+  successful, 0 if a reference has the wrong arguments or the macro refers to itself (directly or through other
+  macros), after raising an error.*/
+static int expandInto(Macro_Table* table, Macro* macro, Macro_Argument* arguments, Text_Buffer* output){
+    Text_Buffer expansion = {NULL, 0, 0};
+    Text_Buffer line = {NULL, 0, 0}; /*current line of the expansion, before references in it are replaced*/
+    Macro_Argument lineArguments[MAX_MACRO_PARAMETERS];
+    Template_Piece* piece;
+    Macro* referenced;
+    size_t tokenLength;
+    int hasReferences = 0, success = 1, i;
+
+    if (macro->parameterCount == 0 && macro->expansionState == EXPANDED && macro->expansionGeneration == table->macroCount){
+        if (output != NULL)
+            appendText(output, getExpansionText(table, macro), macro->expansionLength);
+        return 1;
+    }
+
+    macro->expansionState = EXPANDING;
+    for (i=0; i < macro->pieceCount && success; i++){
+        piece = &macro->pieces[i];
+        if (piece->parameter >= 0)
+            appendText(&line, arguments[piece->parameter].text, arguments[piece->parameter].length);
+        else appendText(&line, table->bodies.text + piece->start, piece->length);
+        if (line.length == 0 || (line.text[line.length - 1] != '\n' && i + 1 < macro->pieceCount))
+            continue;
+
+        /*the line is complete*/
+        referenced = getReferencedMacro(table, line.text, line.length, &tokenLength);
+        if (referenced == NULL)
+            appendText(&expansion, line.text, line.length);
+        else{
+            hasReferences = 1;
+            if (referenced->expansionState == EXPANDING){
+                raiseRecursiveMacro(macro->name, referenced->name);
+                success = 0;
+            }
+            else success = getMacroArguments(referenced, line.text + tokenLength, line.length - tokenLength - (line.text[line.length - 1] == '\n'), lineArguments)
+                && expandInto(table, referenced, lineArguments, &expansion);
+        }
+        line.length = 0;
+    }
+
+    macro->expansionState = success ? EXPANDED : NOT_EXPANDED;
+    if (success && macro->parameterCount == 0){
+        macro->expansionInBodies = !hasReferences;
+        macro->expansionStart = macro->bodyStart;
+        macro->expansionLength = macro->bodyLength;
+        if (hasReferences){
+            macro->expansionStart = table->expansions.length;
+            macro->expansionLength = expansion.length;
+            appendText(&table->expansions, expansion.text, expansion.length);
+        }
+        macro->expansionGeneration = table->macroCount;
+        if (output != NULL)
+            appendText(output, getExpansionText(table, macro), macro->expansionLength);
+    }
+    else if (success && output != NULL)
+        appendText(output, expansion.text, expansion.length);
+
+    free(expansion.text);
+    free(line.text);
+    return success;
+}
+
+
+/*Receives a line (ending with '\n') and, if its first token is the name of an existing macro, sets expansion and
+  length to the body of the macro with its parameters replaced by the arguments that follow the name, where every
+  line that refers to another macro is replaced by the expansion of that macro. The expansion is not terminated and
+  stays valid until the next macro is entered or expanded. Returns 1 if the line refers to a macro, 0 if it does
+  not, and -1 if the arguments are wrong or the macro refers to itself (the error is raised).*/
+int expandMacro(char* line, const char** expansion, size_t* length){
+    Macro_Table* table = getMacroTable();
+    Macro_Argument arguments[MAX_MACRO_PARAMETERS];
+    size_t lineLength = strlen(line), tokenLength;
+    Macro* currentMacro = getReferencedMacro(table, line, lineLength, &tokenLength);
+
+    if (currentMacro == NULL)
+        return 0;
+    if (lineLength > 0 && line[lineLength - 1] == '\n')
+        lineLength--;
+    if (!getMacroArguments(currentMacro, line + tokenLength, lineLength - tokenLength, arguments))
+        return -1;
+    if (currentMacro->parameterCount == 0){
+        if (!expandInto(table, currentMacro, NULL, NULL))
+            return -1;
+        *expansion = getExpansionText(table, currentMacro);
+        *length = currentMacro->expansionLength;
+        return 1;
+    }
+    table->instance.length = 0;
+    if (!expandInto(table, currentMacro, arguments, &table->instance))
+        return -1;
+    *expansion = table->instance.text;
+    *length = table->instance.length;
+    return 1;
+}
+
+
+/*Removes all macros from the macro table but keeps the table allocated so that it can be
+  reused for the next file.*/
+void resetMacroTable(){
+    int i;
+    Macro* currentMacro;
+    Macro_Table* table = getMacroTable();
+    for (i=0; i < table->slotCount; i++){
+        currentMacro = table->slots[i];
+        if (currentMacro == NULL)
+            continue;
+        free(currentMacro->name);
+        free(currentMacro->parameters);
+        free(currentMacro->pieces);
+        free(currentMacro);
+        table->slots[i] = NULL;
+    }
+    table->macroCount = 0;
+    table->bodies.length = 0;
+    table->openBodyStart = 0;
+    table->expansions.length = 0;
+}
+
+
+/*Frees macro table from memory*/
+void freeMacroTable(){
+    Macro_Table* table = getMacroTable();
+    resetMacroTable();
+    free(table->slots);
+    free(table->bodies.text);
+    free(table->expansions.text);
+    free(table->instance.text);
+    free(table);
+    getCurrentContext()->macroTable = NULL;
+}
+
+
+/*Receives string which is supposed to be a macro name. Returns 1 if the name is valid, 0 otherwise.*/
+int isValidMacroName(char* str){
+    if (isOperationName(str)){
+        raiseInvalidMacroName(str, 1);
+        return 0;
+    }
+    if (isRegisterName(str)){
+        raiseInvalidMacroName(str, 0);
+        return 0;
+    }
+    return 1;
+}
@@ -1,36 +1,311 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-#include "header_data.h"
-
-
-
-void assemble(char* filename){
-    initMacroTable();
-    initSymbolTable();
-    initEntriesArray();
-
-    if (preProcessor(filename) != 0){
-        /*Only calls these if pre processor was successful*/
-        firstPass(filename);
-
-        secondPass(filename);
-    }
-
-
-    freeMacroTable();
-    freeSymbolTable();
-    freeEntriesArray();
-}
-
-
-int main(int argc, char** argv){
-    int i;
-    for (i=1; i<argc; i++){
-        assemble(argv[i]);
-    }
-
-    
-    return 1;
-}
\ No newline at end of file
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "header_data.h"
+
+
+static int firstPassJobs = 1; /*number of threads of the first pass of each file (-p N)*/
+static char* cacheDirectory = NULL; /*directory of the build cache (--cache), NULL if the cache is not used*/
+static int emitExpandedSource = 0; /*bool, --emit-am writes the source after the pre processor to the .am file*/
+static int largeMemory = 0; /*bool, --large-memory assembles the files in large memory mode (see setLargeMemory)*/
+static int binaryObjects = 0; /*bool, --format=bin writes a binary object file instead of the .ob, .ext and .ent files*/
+static int crossReference = 0; /*bool, --xref also writes the cross reference of the labels to a .xref file*/
+static Assembler_Context* watchContext = NULL; /*context that is kept between files in watch mode (--watch)*/
+
+
+/*A single file of a batch that is assembled by the worker threads.*/
+typedef struct Batch_File{
+    char* fileName;
+    char* diagnostics; /*everything the assembler printed for this file*/
+    size_t diagnosticsLength;
+    int done; /*bool that indicates whether the file has been assembled*/
+} Batch_File;
+
+
+/*Files of the command line that are shared between the worker threads.*/
+typedef struct Batch{
+    Batch_File* files;
+    int fileCount;
+    int nextFile; /*index of the next file that has not been taken by a worker*/
+    pthread_mutex_t lock;
+    pthread_cond_t fileDone;
+} Batch;
+
+
+/*Assembles a single file. All of the state of the file is kept in its own context and
+  all errors and messages are printed to the given diagnostics stream. In watch mode the context and
+  its tables are kept alive and only reset between files.*/
+void assembleFile(char* filename, FILE* diagnostics){
+    Assembler_Context* context = watchContext;
+
+    if (context == NULL){
+        context = createContext(printDiagnosticToStream, diagnostics);
+        setCurrentContext(context);
+        initMacroTable();
+        initSymbolTable();
+        initEntriesArray();
+        initMemory();
+    }
+    else {
+        resetContext(context);
+        context->sink = printDiagnosticToStream;
+        context->sinkData = diagnostics;
+        setCurrentContext(context);
+        resetMacroTable();
+        resetSymbolTable();
+        resetEntriesArray();
+        resetMemory();
+    }
+    context->firstPassJobs = firstPassJobs;
+    setLargeMemory(largeMemory);
+    context->binaryObjects = binaryObjects;
+    context->crossReference = crossReference;
+
+    if (preProcessorToFirstPass(filename, emitExpandedSource) != 0){
+        /*Only calls the second pass if pre processor was successful*/
+        secondPass(filename);
+    }
+
+    if (context == watchContext)
+        return;
+    freeMacroTable();
+    freeSymbolTable();
+    freeEntriesArray();
+    freeMemory();
+    freeContext(context);
+}
+
+
+/*Assembles a single file, or restores its outputs and messages from the build cache if the same source
+  has been assembled before. The cache does not keep cross references, so files are always assembled with --xref.*/
+void assemble(char* filename, FILE* diagnostics){
+    Cache_Key* cacheKey = NULL;
+    char* capturedDiagnostics;
+    size_t capturedLength;
+    FILE* capture;
+
+    if (cacheDirectory != NULL && !crossReference)
+        cacheKey = getCacheKey(filename, emitExpandedSource, largeMemory, binaryObjects);
+    if (cacheKey == NULL){
+        assembleFile(filename, diagnostics);
+        return;
+    }
+
+    if (!restoreFromCache(cacheDirectory, cacheKey, filename, emitExpandedSource, diagnostics)){
+        /*the messages are captured so that they can be replayed on the next hit*/
+        removeCachedOutputs(filename, emitExpandedSource); /*so that only the outputs of this run are stored*/
+        capture = open_memstream(&capturedDiagnostics, &capturedLength);
+        assembleFile(filename, capture);
+        fclose(capture);
+        fwrite(capturedDiagnostics, 1, capturedLength, diagnostics);
+        storeInCache(cacheDirectory, cacheKey, filename, emitExpandedSource, capturedDiagnostics, capturedLength);
+        free(capturedDiagnostics);
+    }
+    freeCacheKey(cacheKey);
+}
+
+
+/*Assembles a file in watch mode and sets includedFiles to the files its source included, so that they are watched
+  as well. The build cache is not used, since a hit would not tell which files the source includes.*/
+static void assembleWatchedFile(char* filename, FILE* diagnostics, Include_Dependencies* includedFiles){
+    watchContext->includedFiles = includedFiles;
+    assembleFile(filename, diagnostics);
+    watchContext->includedFiles = NULL;
+}
+
+
+/*Watch mode (--watch): keeps a single context with allocated tables, assembles the files and assembles a file again
+  each time its source or a file it includes changes. Returns when the files can no longer be watched.*/
+void watch(char** fileNames, int fileCount){
+    watchContext = createContext(printDiagnosticToStream, stdout);
+    setCurrentContext(watchContext);
+    initMacroTable();
+    initSymbolTable();
+    initEntriesArray();
+    initMemory();
+
+    watchFiles(fileNames, fileCount, assembleWatchedFile);
+
+    setCurrentContext(watchContext);
+    freeMacroTable();
+    freeSymbolTable();
+    freeEntriesArray();
+    freeMemory();
+    freeContext(watchContext);
+    watchContext = NULL;
+}
+
+
+/*Worker thread of a batch. Takes the next file that has not been assembled and assembles it into a
+  buffer until there are no files left.*/
+void* assembleBatchFiles(void* batchPointer){
+    Batch* batch = batchPointer;
+    Batch_File* file;
+    FILE* diagnostics;
+
+    while (1){
+        pthread_mutex_lock(&batch->lock);
+        if (batch->nextFile >= batch->fileCount){
+            pthread_mutex_unlock(&batch->lock);
+            break;
+        }
+        file = &batch->files[batch->nextFile];
+        batch->nextFile++;
+        pthread_mutex_unlock(&batch->lock);
+
+        diagnostics = open_memstream(&file->diagnostics, &file->diagnosticsLength);
+        assemble(file->fileName, diagnostics);
+        fclose(diagnostics);
+
+        pthread_mutex_lock(&batch->lock);
+        file->done = 1;
+        pthread_cond_broadcast(&batch->fileDone);
+        pthread_mutex_unlock(&batch->lock);
+    }
+    return NULL;
+}
+
+
+/*Assembles the given files on jobCount worker threads. Diagnostics of each file are printed together,
+  in the order the files were given, no matter which file finishes first.*/
+void assembleBatch(char** fileNames, int fileCount, int jobCount){
+    Batch batch;
+    pthread_t* workers;
+    int i;
+
+    batch.files = calloc(fileCount, sizeof(Batch_File));
+    batch.fileCount = fileCount;
+    batch.nextFile = 0;
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.fileDone, NULL);
+    for (i=0; i < fileCount; i++)
+        batch.files[i].fileName = fileNames[i];
+
+    if (jobCount > fileCount)
+        jobCount = fileCount;
+    workers = malloc(jobCount * sizeof(pthread_t));
+    for (i=0; i < jobCount; i++)
+        pthread_create(&workers[i], NULL, assembleBatchFiles, &batch);
+
+    /*Print the diagnostics of each file as soon as it and all files before it are done*/
+    for (i=0; i < fileCount; i++){
+        pthread_mutex_lock(&batch.lock);
+        while (!batch.files[i].done)
+            pthread_cond_wait(&batch.fileDone, &batch.lock);
+        pthread_mutex_unlock(&batch.lock);
+
+        fwrite(batch.files[i].diagnostics, 1, batch.files[i].diagnosticsLength, stdout);
+        free(batch.files[i].diagnostics);
+    }
+
+    for (i=0; i < jobCount; i++)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&batch.lock);
+    pthread_cond_destroy(&batch.fileDone);
+    free(workers);
+    free(batch.files);
+}
+
+
+/*Receives the value of the -j option and returns the number of jobs, or 0 if it is not a valid number.*/
+int parseJobCount(char* str){
+    char* end;
+    long jobs;
+    if (str == NULL)
+        return 0;
+    jobs = strtol(str, &end, 10);
+    if (*str == '\0' || *end != '\0' || jobs < 1)
+        return 0;
+    return (int)jobs;
+}
+
+
+int main(int argc, char** argv){
+    int i;
+    int jobCount = 1; /*number of files that are assembled at the same time (-j N)*/
+    int fileCount = 0;
+    int showCacheStats = 0; /*bool, --cache-stats prints the number of cache hits and misses*/
+    int showAllocationStats = 0; /*bool, --alloc-stats prints the allocation counters and the peak memory*/
+    int watchMode = 0; /*bool, --watch assembles the files again whenever they change*/
+    char** fileNames = malloc(argc * sizeof(char*));
+
+    for (i=1; i<argc; i++){
+        if (strcmp(argv[i], "--serve") == 0){
+            /*--serve <socket> keeps running and assembles the files requested on the socket*/
+            free(fileNames);
+            if (i + 1 >= argc){
+                fprintf(stdout, "Error: --serve should be followed by the path of a socket.\n");
+                return 1;
+            }
+            return runServer(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--cache") == 0){
+            if (i + 1 >= argc){
+                fprintf(stdout, "Error: --cache should be followed by the path of the cache directory.\n");
+                free(fileNames);
+                return 1;
+            }
+            cacheDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache-stats") == 0)
+            showCacheStats = 1;
+        else if (strcmp(argv[i], "--alloc-stats") == 0)
+            showAllocationStats = 1;
+        else if (strcmp(argv[i], "--emit-am") == 0)
+            emitExpandedSource = 1;
+        else if (strcmp(argv[i], "--watch") == 0)
+            watchMode = 1;
+        else if (strcmp(argv[i], "--large-memory") == 0)
+            largeMemory = 1;
+        else if (strcmp(argv[i], "--format=bin") == 0)
+            binaryObjects = 1;
+        else if (strcmp(argv[i], "--format=text") == 0)
+            binaryObjects = 0;
+        else if (strcmp(argv[i], "--xref") == 0)
+            crossReference = 1;
+        else if (strncmp(argv[i], "-p", 2) == 0){
+            /*-p N or -pN*/
+            firstPassJobs = parseJobCount(argv[i][2] != '\0' ? argv[i] + 2 : argv[++i]);
+            if (firstPassJobs == 0){
+                fprintf(stdout, "Error: -p should be followed by a positive number of jobs.\n");
+                free(fileNames);
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "-j", 2) == 0){
+            /*-j N or -jN*/
+            jobCount = parseJobCount(argv[i][2] != '\0' ? argv[i] + 2 : argv[++i]);
+            if (jobCount == 0){
+                fprintf(stdout, "Error: -j should be followed by a positive number of jobs.\n");
+                free(fileNames);
+                return 1;
+            }
+        }
+        else fileNames[fileCount++] = argv[i];
+    }
+
+    /*In watch mode the files are assembled by watch, which needs the files they include*/
+    if (!watchMode && jobCount > 1 && fileCount > 1)
+        assembleBatch(fileNames, fileCount, jobCount);
+    else if (!watchMode){
+        for (i=0; i<fileCount; i++){
+            assemble(fileNames[i], stdout);
+        }
+    }
+
+    if (showCacheStats)
+        printCacheStats(stdout);
+    if (showAllocationStats)
+        printAllocationStats(stdout);
+    if (watchMode && fileCount > 0)
+        watch(fileNames, fileCount);
+
+    freeIncludeCache();
+    free(fileNames);
+    return 1;
+}
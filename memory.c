@@ -1,273 +1,829 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-#include "headers/constants.h"
-#include "headers/stringUtils.h"
-#include "headers/utils.h"
-#include "headers/labels.h"
-#include "headers/errors.h"
-
-
-/*Description: this file contains all functions and datatypes that have to do with storing information from the
-  source code into memory. Including the instruction array, data array and entries array. Furthermore, 
-  the function that write the memory to the output files (objects, externs, entries are also found here).*/
-
-
-static char instructionArray[MEMORY_SIZE][MAX_LABEL_LENGTH]; /*holds binary encoding of machine commands in source file*/
-static char dataArray[MEMORY_SIZE][wordSize+1]; /*holds binary encoding of data in source file (.data/.string)*/
-static int IC; /*Instruction counter-points to next available index in instructionArray*/
-static int DC; /*Data counter points to next available index in dataArray*/
-
-static const char registerNames[NUMBER_OF_REGISTERS][4] = {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7"};
-
-static char** entriesArray; /*Will hold addresses of all entry labels declared in the source code*/
-static int entriesArraySize; /*current size of entriesArray*/
-static int entryCount; /*Current number of entries in entriesArray*/
-
-
-/*Initialize entries array*/
-void initEntriesArray(){
-    entriesArraySize = INITIAL_TABLE_SIZE;
-    entryCount = 0;
-    entriesArray = malloc(entriesArraySize * sizeof(char*));
-}
-
-
-/*Receives declaration address of entry label and writes it to the entriesArray. If 
-  there are more entries than the size of the entries array, entries array is enlarged 
-  dynamically.*/
-void enterEntry(char* name){
-    char* entryName;
-    if (entryCount >= entriesArraySize){
-        entriesArraySize += INITIAL_TABLE_SIZE;
-        entriesArray = realloc(entriesArray, entriesArraySize * sizeof(int));
-    }
-    entryName = malloc(strlen(name) * sizeof(char));
-    strcpy(entryName, name);
-
-    entriesArray[entryCount] = entryName;
-    entryCount++;
-}
-
-
-/*Free entries array*/
-void freeEntriesArray(){
-    int i;
-    for (i=0; i < entryCount; i++){
-        free(entriesArray[i]);
-    }
-    free(entriesArray);
-}
-
-
-/*Receives a register name and returns the number of the register (0-7)*/
-int getRegisterNumber(char* registerName){
-    int i;
-    for (i=0; i< NUMBER_OF_REGISTERS; i++){
-        if (strcmp(registerName, registerNames[i]) == 0)
-            return i;
-    }
-    return -1;
-}
-
-
-/*Receives string and returns 1 if the string is the name of a register in the cpu. Returns 0 if not.*/
-int isRegisterName(char* str){
-    int i;
-    if (strlen(str) > 2)
-        /*str is too long to be register name*/
-        return 0;
-    for (i=0; i < NUMBER_OF_REGISTERS; i++){
-        if (strcmp(str, registerNames[i]) == 0)
-            return 1;
-    }
-    return 0;
-}
-
-
-/*Checks if the amount of words in memory is larger than the memory size*/
-void checkMemoryOverFlow(){
-    if ((IC + DC) > MEMORY_SIZE)
-        raiseDataOverFlow();
-}
-
-/*Initializes instruction counter.*/
-void initIC(){
-    IC = MEMORY_START;
-}
-
-/*Initializes data counter.*/
-void initDC(){
-    DC = 0;
-}
-
-/*Returns current value of instruction counter.*/
-int getIC(){
-    return IC;
-}
-
-/*Returns current value of data counter.*/
-int getDC(){
-    return DC;
-}
-
-/*Increments data counter by one.*/
-void incrementDataCounter(){
-    DC++;
-    checkMemoryOverFlow();
-}
-
-/*Increments instruction counter by one.*/
-void incrementInstructionCounter(){
-    IC++;
-    checkMemoryOverFlow();
-}
-
-
-/*Inserts a word into the instruction array at the current instruction counter index.*/
-void writeToInstructionArray(char* binaryWord){
-    binaryWord[wordSize] = '\0';
-    strcpy(instructionArray[IC], binaryWord);
-}
-
-
-/*Inserts a word into the instruction array at the current data counter index.*/
-void writeToDataArray(char* binaryWord){
-    binaryWord[wordSize] = '\0';
-    strcpy(dataArray[DC], binaryWord);
-}
-
-
-/*Iterates through the instruction array and replaces the name of each label found with its binary encoding in the 
-  instruction array. If the label has not been declared, an error is raised.*/
-void encodeLabelsSecondPass(){
-    int i;
-	Label* label;
-    Encoding_Type encodingType;
-    char* bin = malloc((sizeof(char) * wordSize) + 1); /*will hold binary representation of the word*/
-
-	for (i=MEMORY_START; i <= getIC(); i++){
-		label = getSymbol(instructionArray[i]);
-		if (label != NULL){
-            encodingType = label->type;
-
-            encodeLabelAddress(bin, label->value, (int)encodingType); /*encode label*/
-			strcpy(instructionArray[i], bin); /*write to instruction array*/
-            bin[0] = '\0'; /*reset bin*/
-		}
-        /*check if a label name is in the instruction array that has not been encoded*/
-        if (isValidLabelName(instructionArray[i])){
-            /*this means there is a label referenced in the input that has not been declared*/
-            raiseUndeclaredLabelReference(instructionArray[i]);
-            
-        }   
-	}
-    free(bin);
-}
-
-
-/*Receives the name of a source file. Creates an objects file and writes the contents
-  of memory to the objects fils in the correct format.*/
-int writeMemoryToObjectsFile(char* filename){
-    FILE* objectsFile;
-    int i;
-    char currentLine[wordSize * sizeof(int)];
-    char address[sizeof(int) * ADDRESS_LENGTH];
-    char dataSize[sizeof(int) * DATA_LENGTH]; /*will hold size of instruction array and size of data array to be written in file*/
-    char* objectsPath = malloc((strlen(filename) + strlen(OBJECT_FILETYPE)) * sizeof(char));
-
-    sprintf(objectsPath, "%s%s", filename, OBJECT_FILETYPE);
-    sprintf(dataSize, "\t\t%d %d\n", (IC - MEMORY_START), getDC());
-    objectsFile = fopen(objectsPath, "w");
-
-    if (objectsFile == NULL)
-        return 0;
-    
-    fputs(dataSize, objectsFile);
-
-    /*writing instruction array to file*/
-    for (i=MEMORY_START; i < IC; i++){
-        sprintf(address, "0%d", i);
-        sprintf(currentLine, "%s\t%s\n", address, instructionArray[i]);
-        fputs(currentLine, objectsFile);
-    }
-
-    /*writing data array to memory*/
-    for (i=0; i < DC; i++){
-        sprintf(address, "0%d", i + IC);
-        sprintf(currentLine, "%s\t%s\n", address, dataArray[i]);
-        fputs(currentLine, objectsFile);
-    }
-    free(objectsPath);
-    fclose(objectsFile);
-    return 1;
-}
-
-
-/*Receives a filename and writes the names and addresses of all references to external labels 
-  into the externals file*/
-int writeToExternsFile(char* filename){
-    FILE* externsFile;
-    Label* currentLabel;
-    int i;
-    char address[sizeof(int) * ADDRESS_LENGTH];
-    char lineToWrite[MAX_LABEL_LENGTH + (sizeof(int) * ADDRESS_LENGTH) + 1]; /*will hold label name and address*/
-
-    char* externPath = malloc((strlen(filename) + strlen(EXTERNALS_FILETYPE)) * sizeof(char));
-    sprintf(externPath, "%s%s", filename, EXTERNALS_FILETYPE);
-    externsFile = fopen(externPath, "w");
-
-    if (externsFile == NULL)
-        return 0;
-
-    /*Iterate through instruction array and look for label names, if they are external, write them to externals file*/
-    for (i=MEMORY_START; i < IC; i++){
-        if (isValidLabelName(instructionArray[i])){
-            currentLabel = getSymbol(instructionArray[i]);
-            if (currentLabel != NULL && currentLabel->type == EXTERNAL){
-                /*write to externals file*/
-                sprintf(address, "%d", i); /*formatting output*/
-                sprintf(lineToWrite, "%s\t%s\n", instructionArray[i], address); /*formatting output*/
-                fputs(lineToWrite, externsFile);
-            }
-        }
-    }
-    free(externPath);
-    fclose(externsFile);
-    return 1;
-}
-
-
-/*Receives a filename and writes all labels listed in the entries array into the entries file.*/
-int writeToEntriesFile(char* fileName){
-    FILE* entriesFile;
-    int i;
-    char address[sizeof(int) * ADDRESS_LENGTH];
-    Label* currentLabel;
-    char lineToWrite[MAX_LABEL_LENGTH + (sizeof(int) * ADDRESS_LENGTH) + 1]; /*will hold label name and address*/
-
-    char* entriesPath = malloc((strlen(fileName) + strlen(ENTRIES_FILETYPE)) * sizeof(char));
-    sprintf(entriesPath, "%s%s", fileName, ENTRIES_FILETYPE); /*formatting output*/
-    entriesFile = fopen(entriesPath, "w");
-
-    if (entriesFile == NULL)
-        return 0;
-
-    for (i=0; i < entryCount; i++){
-        currentLabel = getSymbol(entriesArray[i]);
-        if (currentLabel != NULL){
-            sprintf(address, "%d", currentLabel->value);
-            sprintf(lineToWrite, "%s\t%s\n", currentLabel->name, address);
-            fputs(lineToWrite, entriesFile);
-        }
-        else{
-            /*label listed as entry has not been declared*/
-            raiseInvalidEntryLabel(entriesArray[i]);
-        }
-
-    }
-    free(entriesPath);
-    fclose(entriesFile);
-    return 1;
-}
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "headers/constants.h"
+#include "headers/stringUtils.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/labels.h"
+#include "headers/errors.h"
+#include "headers/context.h"
+#include "headers/arena.h"
+
+
+/*Description: this file contains all functions and datatypes that have to do with storing information from the
+  source code into memory. Including the instruction array, data array and entries array. Furthermore, 
+  the function that write the memory to the output files (objects, externs, entries are also found here).
+  Words are stored packed (see Machine_Word) and are only written out as text when the objects file is written.*/
+
+
+/*A word of the instruction array that holds the address of a label, which is only known in the second pass.*/
+typedef struct Fixup{
+    int address; /*index of the word in instructionArray*/
+    int symbol; /*index of the label in the symbols of the memory*/
+    int lineNumber; /*line of the statement that references the label*/
+    int column; /*of the label in the line, from 1*/
+    int nextReference; /*index of the next fixup of the same label, -1 for the last one*/
+} Fixup;
+
+
+/*A label that fixups refer to. Its fixups are chained in order, so they are also the index of its references in
+  the source, which the errors and the cross reference are made from.*/
+typedef struct Fixup_Symbol{
+    char* name; /*interned in the arena of the file*/
+    Label* label; /*set by encodeLabelsSecondPass, NULL if the label was not declared*/
+    int firstReference; /*index of the first fixup of the label*/
+    int lastReference;
+} Fixup_Symbol;
+
+
+/*Words of memory, kept in segments of MEMORY_SEGMENT_SIZE words that are allocated when a word in them is first
+  written. The memory grows a segment at a time, so it is never copied to a larger block and words never move.*/
+typedef struct Word_Segments{
+    Machine_Word** segments; /*NULL for a segment that has not been written yet*/
+    int segmentCount; /*size of segments*/
+} Word_Segments;
+
+
+typedef struct Memory_Image{
+    Word_Segments* instructionArray; /*holds binary encoding of machine commands in source file*/
+    Word_Segments* dataArray; /*holds binary encoding of data in source file (.data/.string)*/
+    Fixup* fixups; /*the words of instructionArray that are encoded in the second pass, in order*/
+    int fixupCount;
+    int fixupsSize;
+    Fixup_Symbol* symbols; /*every label that is referenced, once*/
+    int symbolCount;
+    int symbolsSize;
+    int* symbolSlots; /*open addressing hash table (linear probing) of the symbols by name, index + 1, 0 if empty*/
+    int symbolSlotCount; /*always a power of two*/
+    int IC; /*Instruction counter-points to next available index in instructionArray*/
+    int DC; /*Data counter points to next available index in dataArray*/
+    int sharesArrays; /*bool, the arrays belong to the memory of another context (see shareMemory)*/
+    int largeMemory; /*bool, see setLargeMemory*/
+} Memory_Image;
+
+
+/*A label listed by an .entry statement.*/
+typedef struct Entry{
+    char* name; /*interned in the arena of the file*/
+    int lineNumber; /*of the .entry statement, where an error about the label is reported*/
+} Entry;
+
+
+typedef struct Entries_Array{
+    Entry* entriesArray; /*Will hold all entry labels declared in the source code*/
+    int entriesArraySize; /*current size of entriesArray*/
+    int entryCount; /*Current number of entries in entriesArray*/
+} Entries_Array;
+
+
+static const char registerNames[NUMBER_OF_REGISTERS][4] = {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7"};
+
+
+/*Returns the memory of the file currently being assembled.*/
+static Memory_Image* getMemory(){
+    return getCurrentContext()->memory;
+}
+
+
+/*Returns the entries array of the file currently being assembled.*/
+static Entries_Array* getEntries(){
+    return getCurrentContext()->entries;
+}
+
+
+/*Returns the word at the given address, allocating its segment (and making room for it in the table of segments)
+  if it has not been written yet.*/
+static Machine_Word* getWordSlot(Word_Segments* words, int address){
+    int segment = address / MEMORY_SEGMENT_SIZE;
+    int segmentCount = words->segmentCount;
+
+    if (segment >= words->segmentCount){
+        while (segmentCount <= segment)
+            segmentCount = segmentCount == 0 ? 1 : segmentCount * 2;
+        words->segments = realloc(words->segments, segmentCount * sizeof(Machine_Word*));
+        memset(words->segments + words->segmentCount, 0, (segmentCount - words->segmentCount) * sizeof(Machine_Word*));
+        words->segmentCount = segmentCount;
+    }
+    if (words->segments[segment] == NULL)
+        words->segments[segment] = calloc(MEMORY_SEGMENT_SIZE, sizeof(Machine_Word));
+    return &words->segments[segment][address % MEMORY_SEGMENT_SIZE];
+}
+
+
+/*Returns the word at the given address, 0 if it has not been written.*/
+static Machine_Word getWord(Word_Segments* words, int address){
+    int segment = address / MEMORY_SEGMENT_SIZE;
+    if (segment >= words->segmentCount || words->segments[segment] == NULL)
+        return 0;
+    return words->segments[segment][address % MEMORY_SEGMENT_SIZE];
+}
+
+
+/*Frees every segment of words, keeping the table of segments.*/
+static void clearWordSegments(Word_Segments* words){
+    int i;
+    for (i=0; i < words->segmentCount; i++){
+        free(words->segments[i]);
+        words->segments[i] = NULL;
+    }
+}
+
+
+/*Frees words and all of its segments.*/
+static void freeWordSegments(Word_Segments* words){
+    clearWordSegments(words);
+    free(words->segments);
+    free(words);
+}
+
+
+/*Returns the number of words a memory holds.*/
+static int getMemoryLimit(Memory_Image* memory){
+    return memory->largeMemory ? LARGE_MEMORY_SIZE : MEMORY_SIZE;
+}
+
+
+/*Initializes the memory (instruction and data arrays) of the current context.*/
+void initMemory(){
+    Memory_Image* memory = calloc(1, sizeof(Memory_Image));
+    memory->instructionArray = calloc(1, sizeof(Word_Segments));
+    memory->dataArray = calloc(1, sizeof(Word_Segments));
+    memory->symbolSlotCount = FIXUP_SYMBOLS_INITIAL_SLOTS;
+    memory->symbolSlots = calloc(memory->symbolSlotCount, sizeof(int));
+    getCurrentContext()->memory = memory;
+}
+
+
+/*Receives the memory of another context and initializes the memory of the current context with the same arrays
+  but its own counters. The threads of the parallel first pass use this to write straight into the final memory,
+  after reserveMemory allocated every segment they write to.*/
+void shareMemory(struct Memory_Image* sharedMemory){
+    Memory_Image* memory = calloc(1, sizeof(Memory_Image));
+    memory->instructionArray = sharedMemory->instructionArray;
+    memory->dataArray = sharedMemory->dataArray;
+    memory->sharesArrays = 1;
+    memory->largeMemory = sharedMemory->largeMemory;
+    memory->symbolSlotCount = FIXUP_SYMBOLS_INITIAL_SLOTS;
+    memory->symbolSlots = calloc(memory->symbolSlotCount, sizeof(int));
+    getCurrentContext()->memory = memory;
+}
+
+
+/*Receives a bool and turns the large memory mode of the current context on or off. In large memory mode the memory
+  holds LARGE_MEMORY_SIZE words instead of MEMORY_SIZE, and the words are LARGE_WORD_SIZE bits long so that their
+  address field (LARGE_ADDRESS_BITS) can hold any address. Must be set before the first pass of a file.*/
+void setLargeMemory(int largeMemory){
+    getMemory()->largeMemory = largeMemory;
+}
+
+
+/*Returns the number of words the memory of the current context holds.*/
+int getMemorySize(){
+    return getMemoryLimit(getMemory());
+}
+
+
+/*Allocates the segments of every word below the current counters. The parallel first pass calls this once the
+  counters of the file are planned, so that its threads never allocate a segment of the shared arrays.*/
+void reserveMemory(){
+    Memory_Image* memory = getMemory();
+    int limit = getMemoryLimit(memory);
+    int address;
+
+    for (address=0; address < memory->IC && address < limit; address += MEMORY_SEGMENT_SIZE)
+        getWordSlot(memory->instructionArray, address);
+    for (address=0; address < memory->DC && address < limit; address += MEMORY_SEGMENT_SIZE)
+        getWordSlot(memory->dataArray, address);
+}
+
+
+/*Clears the memory of the current context so that it can be reused for the next file. The segments are freed, so a
+  large file does not keep its memory while the next ones are assembled.*/
+void resetMemory(){
+    Memory_Image* memory = getMemory();
+    clearWordSegments(memory->instructionArray);
+    clearWordSegments(memory->dataArray);
+    memory->fixupCount = 0;
+    memory->symbolCount = 0; /*the names are interned in the arena of the file*/
+    memset(memory->symbolSlots, 0, memory->symbolSlotCount * sizeof(int));
+    memory->IC = 0;
+    memory->DC = 0;
+}
+
+
+/*Frees the memory of the current context.*/
+void freeMemory(){
+    Memory_Image* memory = getMemory();
+    if (!memory->sharesArrays){
+        freeWordSegments(memory->instructionArray);
+        freeWordSegments(memory->dataArray);
+    }
+    free(memory->fixups);
+    free(memory->symbols);
+    free(memory->symbolSlots);
+    free(memory);
+    getCurrentContext()->memory = NULL;
+}
+
+
+/*Initialize entries array*/
+void initEntriesArray(){
+    Entries_Array* entries = malloc(sizeof(Entries_Array));
+    entries->entriesArraySize = INITIAL_TABLE_SIZE;
+    entries->entryCount = 0;
+    entries->entriesArray = malloc(entries->entriesArraySize * sizeof(Entry));
+    getCurrentContext()->entries = entries;
+}
+
+
+/*Receives the name of an entry label and writes it to the entriesArray with the current line. If 
+  there are more entries than the size of the entries array, entries array is enlarged 
+  dynamically.*/
+void enterEntry(char* name){
+    Entries_Array* entries = getEntries();
+    if (entries->entryCount >= entries->entriesArraySize){
+        entries->entriesArraySize += INITIAL_TABLE_SIZE;
+        entries->entriesArray = realloc(entries->entriesArray, entries->entriesArraySize * sizeof(Entry));
+    }
+    entries->entriesArray[entries->entryCount].name = internString(name);
+    entries->entriesArray[entries->entryCount].lineNumber = getCurrentContext()->lineNumber;
+    entries->entryCount++;
+}
+
+
+/*Removes all entries from the entries array but keeps it allocated so that it can be
+  reused for the next file.*/
+void resetEntriesArray(){
+    Entries_Array* entries = getEntries();
+    entries->entryCount = 0; /*the names are interned in the arena of the file*/
+}
+
+
+/*Free entries array*/
+void freeEntriesArray(){
+    Entries_Array* entries = getEntries();
+    resetEntriesArray();
+    free(entries->entriesArray);
+    free(entries);
+    getCurrentContext()->entries = NULL;
+}
+
+
+/*Receives a register name and returns the number of the register (0-7)*/
+int getRegisterNumber(char* registerName){
+    int i;
+    for (i=0; i< NUMBER_OF_REGISTERS; i++){
+        if (strcmp(registerName, registerNames[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+/*Receives string and returns 1 if the string is the name of a register in the cpu. Returns 0 if not.*/
+int isRegisterName(char* str){
+    int i;
+    if (strlen(str) > 2)
+        /*str is too long to be register name*/
+        return 0;
+    for (i=0; i < NUMBER_OF_REGISTERS; i++){
+        if (strcmp(str, registerNames[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+
+/*Checks if the amount of words in memory is larger than the memory size*/
+void checkMemoryOverFlow(){
+    Memory_Image* memory = getMemory();
+    if ((memory->IC + memory->DC) > getMemoryLimit(memory))
+        raiseDataOverFlow();
+}
+
+/*Initializes instruction counter.*/
+void initIC(){
+    getMemory()->IC = MEMORY_START;
+}
+
+/*Initializes data counter.*/
+void initDC(){
+    getMemory()->DC = 0;
+}
+
+/*Sets both counters, so that the next words are written at the given indexes.*/
+void setMemoryCounters(int IC, int DC){
+    getMemory()->IC = IC;
+    getMemory()->DC = DC;
+}
+
+/*Returns current value of instruction counter.*/
+int getIC(){
+    return getMemory()->IC;
+}
+
+/*Returns current value of data counter.*/
+int getDC(){
+    return getMemory()->DC;
+}
+
+/*Increments data counter by one.*/
+void incrementDataCounter(){
+    getMemory()->DC++;
+    checkMemoryOverFlow();
+}
+
+/*Increments instruction counter by one.*/
+void incrementInstructionCounter(){
+    getMemory()->IC++;
+    checkMemoryOverFlow();
+}
+
+
+/*Inserts a word into the instruction array at the current instruction counter index.*/
+void writeToInstructionArray(Machine_Word word){
+    Memory_Image* memory = getMemory();
+    if (memory->IC >= getMemoryLimit(memory))
+        return; /*the memory overflowed, which was already reported by checkMemoryOverFlow*/
+    *getWordSlot(memory->instructionArray, memory->IC) = word;
+}
+
+
+/*Returns the hash of an interned name. Interned names are equal only if they are the same copy, so the address of
+  the copy is hashed instead of its text.*/
+static unsigned long hashSymbolName(char* name){
+    return (((unsigned long)name >> 3) * 2654435761UL) & 0xffffffffUL;
+}
+
+
+/*Doubles the number of slots of the symbols of a memory and enters all symbols into the new slots.*/
+static void growSymbolSlots(Memory_Image* memory){
+    unsigned long mask, j;
+    int i;
+
+    free(memory->symbolSlots);
+    memory->symbolSlotCount *= 2;
+    memory->symbolSlots = calloc(memory->symbolSlotCount, sizeof(int));
+    mask = memory->symbolSlotCount - 1;
+    for (i=0; i < memory->symbolCount; i++){
+        for (j = hashSymbolName(memory->symbols[i].name) & mask; memory->symbolSlots[j] != 0; j = (j + 1) & mask)
+            ;
+        memory->symbolSlots[j] = i + 1;
+    }
+}
+
+
+/*Receives the name of a label, interned in the arena of the file, and returns the slot of the symbols of a memory
+  that holds it, or the empty slot where it belongs if it is not there.*/
+static unsigned long findFixupSymbolSlot(Memory_Image* memory, char* name){
+    unsigned long mask = memory->symbolSlotCount - 1;
+    unsigned long i;
+
+    for (i = hashSymbolName(name) & mask; memory->symbolSlots[i] != 0; i = (i + 1) & mask){
+        if (memory->symbols[memory->symbolSlots[i] - 1].name == name)
+            break;
+    }
+    return i;
+}
+
+
+/*Receives the name of a label and returns its index in the symbols of a memory, adding it if it is not there yet.*/
+static int getFixupSymbol(Memory_Image* memory, char* name){
+    unsigned long i;
+    Fixup_Symbol* symbol;
+
+    name = internString(name);
+    if ((memory->symbolCount + 1) * 2 > memory->symbolSlotCount)
+        growSymbolSlots(memory);
+    i = findFixupSymbolSlot(memory, name);
+    if (memory->symbolSlots[i] != 0)
+        return memory->symbolSlots[i] - 1;
+
+    if (memory->symbolCount == memory->symbolsSize){
+        memory->symbolsSize = memory->symbolsSize == 0 ? INITIAL_TABLE_SIZE : memory->symbolsSize * 2;
+        memory->symbols = realloc(memory->symbols, memory->symbolsSize * sizeof(Fixup_Symbol));
+    }
+    symbol = &memory->symbols[memory->symbolCount];
+    symbol->name = name;
+    symbol->label = NULL;
+    symbol->firstReference = symbol->lastReference = -1;
+    memory->symbolSlots[i] = ++memory->symbolCount;
+    return memory->symbolCount - 1;
+}
+
+
+/*Appends a fixup to the fixups of a memory and chains it to the references of its label.*/
+static void addFixup(Memory_Image* memory, int address, int symbol, int lineNumber, int column){
+    Fixup* fixup;
+    Fixup_Symbol* label = &memory->symbols[symbol];
+
+    if (memory->fixupCount == memory->fixupsSize){
+        memory->fixupsSize = memory->fixupsSize == 0 ? INITIAL_TABLE_SIZE : memory->fixupsSize * 2;
+        memory->fixups = realloc(memory->fixups, memory->fixupsSize * sizeof(Fixup));
+    }
+    fixup = &memory->fixups[memory->fixupCount];
+    fixup->address = address;
+    fixup->symbol = symbol;
+    fixup->lineNumber = lineNumber;
+    fixup->column = column;
+    fixup->nextReference = -1;
+
+    if (label->lastReference >= 0)
+        memory->fixups[label->lastReference].nextReference = memory->fixupCount;
+    else label->firstReference = memory->fixupCount;
+    label->lastReference = memory->fixupCount;
+    memory->fixupCount++;
+}
+
+
+/*Receives the name of a label whose address is the word at the current instruction counter index and the column of
+  the label in the current line. The word is left empty and a fixup is recorded, so that encodeLabelsSecondPass
+  encodes the address of the label into the word.*/
+void writeFixup(char* labelName, int column){
+    Memory_Image* memory = getMemory();
+    if (memory->IC >= getMemoryLimit(memory))
+        return; /*the memory overflowed, which was already reported by checkMemoryOverFlow*/
+    *getWordSlot(memory->instructionArray, memory->IC) = 0;
+    addFixup(memory, memory->IC, getFixupSymbol(memory, labelName), getCurrentContext()->lineNumber, column);
+}
+
+
+/*Receives the memory of a context that shares the arrays of the current context (see shareMemory) and appends its
+  fixups to the fixups of the current context. The parallel first pass calls this for each chunk in order, so that
+  the fixups stay in the order of their addresses.*/
+void takeFixups(struct Memory_Image* sharedMemory){
+    Memory_Image* memory = getMemory();
+    int* symbols = malloc((sharedMemory->symbolCount + 1) * sizeof(int)); /*index in memory of each shared symbol*/
+    Fixup* fixup;
+    int i;
+
+    for (i=0; i < sharedMemory->symbolCount; i++)
+        symbols[i] = getFixupSymbol(memory, sharedMemory->symbols[i].name);
+    for (i=0; i < sharedMemory->fixupCount; i++){
+        fixup = &sharedMemory->fixups[i];
+        addFixup(memory, fixup->address, symbols[fixup->symbol], fixup->lineNumber, fixup->column);
+    }
+    free(symbols);
+}
+
+
+/*Inserts a word into the instruction array at the current data counter index.*/
+void writeToDataArray(Machine_Word word){
+    Memory_Image* memory = getMemory();
+    if (memory->DC >= getMemoryLimit(memory))
+        return; /*the memory overflowed, which was already reported by checkMemoryOverFlow*/
+    *getWordSlot(memory->dataArray, memory->DC) = word;
+}
+
+
+/*Receives a label that fixups refer to and returns the lines of its references, each line once, separated and
+  followed by a space (must be freed).*/
+static char* getReferenceLines(Memory_Image* memory, Fixup_Symbol* symbol){
+    char* lines = NULL;
+    size_t linesLength;
+    FILE* stream = open_memstream(&lines, &linesLength);
+    int reference;
+    int lastLine = 0;
+
+    for (reference = symbol->firstReference; reference >= 0; reference = memory->fixups[reference].nextReference){
+        if (memory->fixups[reference].lineNumber != lastLine)
+            fprintf(stream, "%d ", memory->fixups[reference].lineNumber);
+        lastLine = memory->fixups[reference].lineNumber;
+    }
+    fclose(stream);
+    return lines;
+}
+
+
+/*Looks up every label that is referenced in the symbol table, once, and encodes its address into the words of its
+  fixups. If the label has not been declared, a single error lists the lines of its references.*/
+void encodeLabelsSecondPass(){
+    int i;
+    Fixup* fixup;
+    Fixup_Symbol* symbol;
+    char* lines;
+    Memory_Image* memory = getMemory();
+
+    for (i=0; i < memory->symbolCount; i++){
+        symbol = &memory->symbols[i];
+        symbol->label = getSymbol(symbol->name);
+        if (symbol->label == NULL && isValidLabelName(symbol->name)){
+            /*this means there is a label referenced in the input that has not been declared*/
+            lines = getReferenceLines(memory, symbol);
+            raiseUndeclaredLabelReference(symbol->name, lines);
+            free(lines);
+        }
+    }
+
+    for (i=0; i < memory->fixupCount; i++){
+        fixup = &memory->fixups[i];
+        symbol = &memory->symbols[fixup->symbol];
+        if (symbol->label != NULL)
+            encodeLabelAddress(getWordSlot(memory->instructionArray, fixup->address), symbol->label->value,
+                (int)symbol->label->type, memory->largeMemory ? LARGE_ADDRESS_BITS : ADDRESS_BITS);
+    }
+}
+
+
+/*Receives the end of the text in an output buffer, the address of a word, the word and its width in bits, and
+  writes the line of the word in the objects file into the buffer. Returns the end of the line.*/
+static char* renderObjectLine(char* text, int address, Machine_Word word, int width){
+    *text++ = '0';
+    text = renderDecimal(address, text);
+    *text++ = '\t';
+    text = renderWord(word, width, text);
+    *text++ = '\n';
+    return text;
+}
+
+
+/*Receives the objects file (or any stream) and writes the contents
+  of memory to it in the correct format. The lines are rendered into a buffer that is written whenever it is
+  almost full. In large memory mode every word is LARGE_WORD_SIZE chars long.*/
+int writeMemoryToObjectsFile(FILE* objectsFile){
+    int i;
+    char* buffer;
+    char* end;
+    char* flushLimit; /*the buffer is written once its end passes this, so that a whole line always fits*/
+    Memory_Image* memory = getMemory();
+    int limit = getMemoryLimit(memory);
+    int width = memory->largeMemory ? LARGE_WORD_SIZE : wordSize;
+
+    if (objectsFile == NULL)
+        return 0;
+
+    fprintf(objectsFile, "\t\t%d %d\n", (memory->IC - MEMORY_START), getDC());
+
+    buffer = end = malloc(OBJECTS_BUFFER_SIZE);
+    flushLimit = buffer + OBJECTS_BUFFER_SIZE - OBJECTS_LINE_LENGTH;
+
+    /*writing instruction array to file*/
+    for (i=MEMORY_START; i < memory->IC && i < limit; i++){
+        end = renderObjectLine(end, i, getWord(memory->instructionArray, i), width);
+        if (end > flushLimit){
+            fwrite(buffer, 1, end - buffer, objectsFile);
+            end = buffer;
+        }
+    }
+
+    /*writing data array to memory*/
+    for (i=0; i < memory->DC && i < limit; i++){
+        end = renderObjectLine(end, i + memory->IC, getWord(memory->dataArray, i), width);
+        if (end > flushLimit){
+            fwrite(buffer, 1, end - buffer, objectsFile);
+            end = buffer;
+        }
+    }
+    fwrite(buffer, 1, end - buffer, objectsFile);
+    free(buffer);
+    return 1;
+}
+
+
+/*Receives the externals file (or any stream) and writes the names and addresses of all references to external labels
+  into it, from the fixups. Must be called after encodeLabelsSecondPass, which looks up the labels.*/
+int writeToExternsFile(FILE* externsFile){
+    Fixup* fixup;
+    Fixup_Symbol* symbol;
+    int i;
+    Memory_Image* memory = getMemory();
+
+    if (externsFile == NULL)
+        return 0;
+
+    for (i=0; i < memory->fixupCount; i++){
+        fixup = &memory->fixups[i];
+        symbol = &memory->symbols[fixup->symbol];
+        if (symbol->label != NULL && symbol->label->type == EXTERNAL)
+            fprintf(externsFile, "%s\t%d\n", symbol->name, fixup->address);
+    }
+    return 1;
+}
+
+
+/*Receives a label that fixups refer to and writes the line and column of each of its references into a stream, each
+  one after a tab or a space.*/
+static void writeReferences(FILE* stream, Memory_Image* memory, Fixup_Symbol* symbol){
+    int reference;
+    char separator = '\t';
+
+    for (reference = symbol->firstReference; reference >= 0; reference = memory->fixups[reference].nextReference){
+        fprintf(stream, "%c%d:%d", separator, memory->fixups[reference].lineNumber, memory->fixups[reference].column);
+        separator = ' ';
+    }
+}
+
+
+/*Returns the name of the type of a label in the cross reference file.*/
+static const char* getLabelTypeName(Label* label){
+    if (label->type == EXTERNAL)
+        return "external";
+    return label->tag == DATATAG ? "data" : "code";
+}
+
+
+/*Receives the cross reference file (or any stream) and writes a line for every label of the file: its name, type,
+  address and the line that declared it, followed by the line:column of each reference to it. The labels are written in
+  the order they were declared, followed by the labels that are referenced without being declared, from the index of
+  references the fixups keep. Must be called after encodeLabelsSecondPass, which looks up the labels.*/
+int writeCrossReferenceFile(FILE* xrefFile){
+    Memory_Image* memory = getMemory();
+    Fixup_Symbol* symbol;
+    Label* label;
+    unsigned long slot;
+    int i;
+
+    if (xrefFile == NULL)
+        return 0;
+
+    for (i=0; (label = getSymbolByIndex(i)) != NULL; i++){
+        if (getSymbol(label->name) != label)
+            continue; /*an external that is declared again, which lookups never find*/
+        fprintf(xrefFile, "%s\t%s\t%d\t%d", label->name, getLabelTypeName(label), label->value, label->lineNumber);
+        slot = findFixupSymbolSlot(memory, internString(label->name));
+        if (memory->symbolSlots[slot] != 0)
+            writeReferences(xrefFile, memory, &memory->symbols[memory->symbolSlots[slot] - 1]);
+        fputc('\n', xrefFile);
+    }
+
+    for (i=0; i < memory->symbolCount; i++){
+        symbol = &memory->symbols[i];
+        if (symbol->label != NULL || !isValidLabelNameNoError(symbol->name))
+            continue;
+        fprintf(xrefFile, "%s\tundeclared\t-\t-", symbol->name);
+        writeReferences(xrefFile, memory, symbol);
+        fputc('\n', xrefFile);
+    }
+    return 1;
+}
+
+
+/*Receives an entry of the entries array and returns the label it lists. If the label has not been declared, an
+  error is raised at the line of its .entry statement and NULL is returned.*/
+static Label* getEntryLabel(Entry* entry){
+    Label* label = getSymbol(entry->name);
+    if (label == NULL)
+        raiseInvalidEntryLabel(entry->name, entry->lineNumber);
+    return label;
+}
+
+
+/*Receives the entries file (or any stream) and writes all labels listed in the entries array into it.*/
+int writeToEntriesFile(FILE* entriesFile){
+    Entries_Array* entries = getEntries();
+    Label* currentLabel;
+    int i;
+
+    if (entriesFile == NULL)
+        return 0;
+
+    for (i=0; i < entries->entryCount; i++){
+        currentLabel = getEntryLabel(&entries->entriesArray[i]);
+        if (currentLabel != NULL)
+            fprintf(entriesFile, "%s\t%d\n", currentLabel->name, currentLabel->value);
+    }
+    return 1;
+}
+
+
+/*Writes the lowest bytes bytes of value at at, least significant byte first.*/
+static unsigned char* putLittleEndian(unsigned char* at, unsigned long value, int bytes){
+    int i;
+    for (i=0; i < bytes; i++){
+        *at++ = (unsigned char)(value & 0xff);
+        value >>= 8;
+    }
+    return at;
+}
+
+
+/*Returns number rounded up to a multiple of 4, so that every table of the binary object file is aligned.*/
+static unsigned long alignBinaryOffset(unsigned long number){
+    return (number + 3) & ~3UL;
+}
+
+
+/*Receives the binary object file (or any stream) and writes the whole output of the file into it: the words of the
+  memory, the entries and the references to external labels. The layout can be mapped and used in place; every number
+  is little endian and every table starts at a multiple of 4 bytes:
+    header:  BINARY_OBJECT_HEADER_FIELDS unsigned 32 bit numbers: the magic "ASOB", the version of the format, the
+             bits of a word, the address of the first word, the number of instruction words, the number of data words,
+             the number of entries, the number of external references, and the offsets of the words, the entries, the
+             external references and the names, and the size of the names.
+    words:   the instruction words and then the data words, 2 bytes each (4 if a word has more than 16 bits).
+    entries: a pair of unsigned 32 bit numbers for each entry, the offset of its name and its address.
+    externs: a pair of unsigned 32 bit numbers for each reference to an external label, the offset of its name and the
+             address of the word that refers to it.
+    names:   the names of the labels, each one ends with '\0'. The name of an external label is stored once.
+  Like writeToEntriesFile, an error is raised for an entry whose label has not been declared. Must be called after
+  encodeLabelsSecondPass, which looks up the labels.*/
+int writeToBinaryObjectsFile(FILE* binaryFile){
+    Memory_Image* memory = getMemory();
+    Entries_Array* entries = getEntries();
+    int limit = getMemoryLimit(memory);
+    int wordBits = memory->largeMemory ? LARGE_WORD_SIZE : wordSize;
+    int wordBytes = wordBits > 16 ? 4 : 2;
+    int instructionCount = (memory->IC < limit ? memory->IC : limit) - MEMORY_START;
+    int dataCount = memory->DC < limit ? memory->DC : limit;
+    int listedEntries = getCurrentContext()->outputEntries ? entries->entryCount : 0; /*like the .ent file, see secondPassToStreams*/
+    int entryCount = 0, externCount = 0;
+    unsigned long* nameOffsets = malloc((memory->symbolCount + 1) * sizeof(unsigned long)); /*of each fixup symbol, 0 if not written yet*/
+    unsigned long wordsOffset, entriesOffset, externsOffset, namesOffset, namesSize = 0, size;
+    unsigned char* buffer;
+    unsigned char* at;
+    unsigned char* name;
+    Label** entryLabels = malloc((listedEntries + 1) * sizeof(Label*));
+    Fixup_Symbol* symbol;
+    Fixup* fixup;
+    int i;
+
+    if (binaryFile == NULL){
+        free(nameOffsets);
+        free(entryLabels);
+        return 0;
+    }
+
+    /*finding the size of every table*/
+    for (i=0; i < listedEntries; i++){
+        entryLabels[i] = getEntryLabel(&entries->entriesArray[i]);
+        if (entryLabels[i] != NULL){
+            entryCount++;
+            namesSize += strlen(entryLabels[i]->name) + 1;
+        }
+    }
+    for (i=0; i < memory->symbolCount; i++){
+        nameOffsets[i] = 0;
+        if (memory->symbols[i].label != NULL && memory->symbols[i].label->type == EXTERNAL)
+            namesSize += strlen(memory->symbols[i].name) + 1;
+    }
+    for (i=0; i < memory->fixupCount; i++){
+        symbol = &memory->symbols[memory->fixups[i].symbol];
+        if (symbol->label != NULL && symbol->label->type == EXTERNAL)
+            externCount++;
+    }
+
+    wordsOffset = BINARY_OBJECT_HEADER_FIELDS * 4;
+    entriesOffset = alignBinaryOffset(wordsOffset + (unsigned long)(instructionCount + dataCount) * wordBytes);
+    externsOffset = entriesOffset + (unsigned long)entryCount * 8;
+    namesOffset = externsOffset + (unsigned long)externCount * 8;
+    size = alignBinaryOffset(namesOffset + namesSize);
+    buffer = calloc(size, 1);
+
+    at = buffer;
+    memcpy(at, BINARY_OBJECT_MAGIC, 4);
+    at = putLittleEndian(at + 4, BINARY_OBJECT_VERSION, 4);
+    at = putLittleEndian(at, wordBits, 4);
+    at = putLittleEndian(at, MEMORY_START, 4);
+    at = putLittleEndian(at, instructionCount, 4);
+    at = putLittleEndian(at, dataCount, 4);
+    at = putLittleEndian(at, entryCount, 4);
+    at = putLittleEndian(at, externCount, 4);
+    at = putLittleEndian(at, wordsOffset, 4);
+    at = putLittleEndian(at, entriesOffset, 4);
+    at = putLittleEndian(at, externsOffset, 4);
+    at = putLittleEndian(at, namesOffset, 4);
+    putLittleEndian(at, namesSize, 4);
+
+    at = buffer + wordsOffset;
+    for (i=MEMORY_START; i < MEMORY_START + instructionCount; i++)
+        at = putLittleEndian(at, getWord(memory->instructionArray, i), wordBytes);
+    for (i=0; i < dataCount; i++)
+        at = putLittleEndian(at, getWord(memory->dataArray, i), wordBytes);
+
+    at = buffer + entriesOffset;
+    name = buffer + namesOffset;
+    for (i=0; i < listedEntries; i++){
+        if (entryLabels[i] == NULL)
+            continue;
+        at = putLittleEndian(at, name - (buffer + namesOffset), 4);
+        at = putLittleEndian(at, entryLabels[i]->value, 4);
+        strcpy((char*)name, entryLabels[i]->name);
+        name += strlen(entryLabels[i]->name) + 1;
+    }
+
+    at = buffer + externsOffset;
+    for (i=0; i < memory->fixupCount; i++){
+        fixup = &memory->fixups[i];
+        symbol = &memory->symbols[fixup->symbol];
+        if (symbol->label == NULL || symbol->label->type != EXTERNAL)
+            continue;
+        if (nameOffsets[fixup->symbol] == 0){
+            /*offsets are kept one past the name, so that 0 means the name has not been written*/
+            nameOffsets[fixup->symbol] = name - (buffer + namesOffset) + 1;
+            strcpy((char*)name, symbol->name);
+            name += strlen(symbol->name) + 1;
+        }
+        at = putLittleEndian(at, nameOffsets[fixup->symbol] - 1, 4);
+        at = putLittleEndian(at, fixup->address, 4);
+    }
+
+    fwrite(buffer, 1, size, binaryFile);
+    free(buffer);
+    free(nameOffsets);
+    free(entryLabels);
+    return 1;
+}
@@ -1,310 +1,246 @@
-#include <string.h>
-#include <ctype.h>
-#include <stdlib.h>
-#include <stdio.h>
-
-#include "headers/labels.h"
-#include "headers/memory.h"
-#include "headers/constants.h"
-#include "headers/errors.h"
-#include "headers/stringUtils.h"
-
-
-/*Description: this file contains all functions and datatypes that have to do with getting and checking operands
-  of operations found in source code.*/
-
-
-typedef enum {IMMEDIATE, DIRECT, JUMP, DIRECT_REGISTER, NO_TYPE} Assignment_Type; /*all types of operands*/
-
-Assignment_Type getAssignmentType(char* operand, int firstJumpCheck);
-
-
-/*Receives pointer to a section of a statement and returns the jump operand in the statement.
-  If no operand is found, returns null.*/
-char* getJumpOperand(char* pointer){
-    char* operand = malloc(strlen(pointer) + 1);
-    int i = 0;
-    trimWhitespace(pointer);
-
-    while (*pointer && *pointer != '\n'){
-        
-        operand[i] = *pointer;
-        pointer++;
-        i++;
-    }
-    if (i == 0)
-        /*No operand found*/
-        return NULL;
-    
-    operand[i] = '\0';
-    return operand;
-}
-
-
-/*Receives pointer to a section of a statement and returns the first operand that is encountered.
-  If no operand is found, return null.*/
-char* getSingleOperand(char* pointer){
-    char* operand = malloc(strlen(pointer) + 1);
-    int i = 0;
-    trimWhitespace(pointer);
-
-    while (*pointer && !isspace(*pointer) && *pointer != ','){
-        /*Iterates until reaching a space or a comma*/
-        operand[i] = *pointer;
-        pointer++;
-        i++;
-    }
-    if (i == 0)
-        /*No operand found*/
-        return NULL;
-    operand[i] = '\0';
-    return operand;
-}
-
-
-/*Receives a pointer to a section of a statement and returns the operand after the first operand.
-  If no operand is found, returns null.*/
-char* getSecondOperand(char* pointer){
-    char* operand = malloc(MAX_INSTRUCTION_LENGTH + 1);
-    int lookForNextOperand = 0; /*Bool flag that indicates if to look for second operand*/
-    int withinSecondOperand = 0; /*Bool flag that indicates if loop has reached the second operand*/
-    int i = 0;
-
-    while (*pointer){
-
-        if (lookForNextOperand && (isalnum(*pointer) || *pointer == '#'))
-            /*Found beginning of next operand*/
-            withinSecondOperand = 1;
-
-        if (withinSecondOperand && isspace(*pointer))
-            break;
-
-        if (withinSecondOperand){
-            /*Add chars to second operand if they are not spaces*/
-            operand[i] = *pointer;
-            i++;
-        }
-
-        if (*pointer == ','){
-            /*Reached end of first operand*/
-            lookForNextOperand = 1;
-        }
-        pointer++;
-    }
-    if (i == 0)
-        /*No operand found*/
-        return NULL;
-    operand[i] = '\0';
-    return operand;
-}
-
-
-/*Receives a jump operand and returns the label before the parentheses*/
-char* getJumpLabel(char* operand){
-	int i = 0;
-	char* label = malloc(strlen(operand) * sizeof(char));
-	char* pointer = operand;
-	while (*pointer){
-		if (*pointer == '('){
-			/*reached end of label in jump operand*/
-			label[i] = '\0';
-			break;
-		}
-		label[i] = *pointer;
-		i++;
-		pointer++;
-	}
-	return label;
-}
-
-
-/*Receives a jump operand and returns the first operand within the parentheses.*/
-char* getJumpSourceOperand(char* operand){
-	int i = 0;
-	int withinParentheses = 0;
-	char* sourceOperand = malloc(strlen(operand) * sizeof(char));
-	char* pointer = operand;
-	while (*pointer){
-		if (*pointer == '(')
-			withinParentheses = 1;
-
-		if (withinParentheses && *pointer != '(' && *pointer != ','){ 
-			sourceOperand[i] = *pointer;
-			i++;
-		}
-		if (*pointer == ','){
-			/*reached end of first operand*/
-			sourceOperand[i] = '\0';
-			break;
-		}
-		pointer++;
-	}
-	return sourceOperand;
-}
-
-
-/*Receives a jump label and returns the second operand within the parentheses.*/
-char* getJumpDestinationOperand(char* operand){
-	int i = 0;
-	int afterComma = 0;
-	char* destOperand = malloc(strlen(operand) * sizeof(char));
-	char* pointer = operand;
-
-	while (*pointer){
-		if (*pointer == ',')
-			afterComma = 1;
-
-		if (afterComma && *pointer != ',' && *pointer != ')'){
-			destOperand[i] = *pointer;
-			i++;
-		}
-		if (*pointer == ')'){
-			/*Reached end of destination operand*/
-			destOperand[i] = '\0';
-			break;
-		}
-		pointer++;
-	}
-	return destOperand;
-}
-
-
-/*Receives a statement and returns 1 if the statement contains a possible jump operand, 
-  returns 0 otherwise.*/
-int isPossibleJumpOperand(char* statement){
-    if (strchr(statement, '(') || strchr(statement, ')'))
-        return 1;
-    else return 0;
-}
-
-
-/*Receives a possible jump operand (operand with parentheses) and gets the label before the parentheses, 
-  and the source and destination operands within the parentheses in order to check the validity of each seperate
-  part of the jump operand. Also checks for syntax errors in the operand. Returns 1 if operand is valid, 0 otherwise.
-  Because this function is called multiple times on the same operand, firstCheck acts as a bool to indicate whether
-  to check for parentheses (this is only needed during the first call)*/
-int isValidJumpOperand(char* operand, int firstCheck){
-	char* label = malloc(strlen(operand) * sizeof(char));
-	char* firstOperand = malloc(strlen(operand) * sizeof(char));
-	char* secondOperand = malloc(strlen(operand) * sizeof(char));
-	char* pointer = operand;
-	int i = 0;
-
-	int withinParentheses = 0; /*Bool to indicate if within parentheses or not*/
-	int withinSecondOperand = 0; /*Bool to indicate if loop has reached second operand*/
-
-	checkTooManyParentheses(operand);
-	if (firstCheck && (!strchr(operand, '(') || !strchr(operand, ')'))){
-		raiseMissingParenthesesInJumpOperand();
-		return 0;
-	}
-
-	while (*pointer){
-		if (isspace(*pointer)){
-			/*Should be no spaces in jump operand*/
-			raiseSpaceInJumpOperand();
-			return 0;
-		}
-
-		if (!withinParentheses && *pointer != '('){
-			/*add char to label*/
-			label[i] = *pointer;
-			i++;
-		}
-
-		if (withinParentheses && !withinSecondOperand && *pointer != ','){
-			/*add char to first operand*/
-			firstOperand[i] = *pointer;
-			i++;
-		}
-
-		if (withinParentheses && withinSecondOperand && *pointer != ')'){
-			/*add char to second operand*/
-			secondOperand[i] = *pointer;
-			i++;
-		}
-
-		if (*pointer == '('){
-			withinParentheses = 1;
-			label[i] = '\0'; /*terminate outside label*/
-			i = 0; /*Reset index to add chars to firstOperand*/
-		}
-
-		if (*pointer == ','){
-			withinSecondOperand = 1;
-			firstOperand[i] = '\0'; /*terminte first operand*/
-			i = 0;
-		}
-		pointer++;
-	}
-	secondOperand [i] = '\0'; /*terminate second operand*/
-
-	/*check validity of internal operands, firstcheck = 0 now*/
-	if (getAssignmentType(label, 0) == NO_TYPE || getAssignmentType(firstOperand, 0) == NO_TYPE || getAssignmentType(secondOperand, 0) == NO_TYPE){
-		/*One of the operands in the jump operand has invalid syntax*/
-		free(label);
-		free(firstOperand);
-		free(secondOperand);
-		return 0;
-	}
-	free(label);
-	free(firstOperand);
-	free(secondOperand);
-	return 1;
-}
-
-/*Receives an operand and checks if it is a valid number to be used as an operand.
-  Returns 1 if number is valid operand, 0 otherwise.*/
-int isValidNumber(char* operand){
-	char* pointer = operand;
-	if (operand == NULL)
-		return 0;
-	if (operand[1] == '-' || operand[1] == '+')
-		pointer += 2; /*skips # and + or -*/
-	else pointer+= 1; /*skips only #*/
-	while (*pointer){
-		if (!isdigit(*pointer))
-			/*non digit char in operand*/
-			return 0;
-		pointer++;
-	}
-	return 1;
-}
-
-
-/*Receives an operand as string and returns it as a valid integer*/
-int convertOperandToInt(char* operand){
-	char* pointer = operand;
-	if (operand[1] == '+')
-		pointer += 2; /*skips # and +*/
-	else pointer+= 1; /*skips only #*/
-	return atoi(pointer);
-}
-
-
-/*Receives an operand and analyzes it to determine its assignment type.
-  firstJumpCheck acts as a bool that is needed for the isValidJumpOperand function*/
-Assignment_Type getAssignmentType(char* operand, int firstJumpCheck){
-	if (operand == NULL)
-		return NO_TYPE;
-	if (isValidNumber(operand) && operand[0] == '#')
-		/*operand is immediate number*/
-		return IMMEDIATE;
-
-	if (isValidLabelNameNoError(operand))
-		/*operand is a label*/
-		return DIRECT;
-
-	if (isPossibleJumpOperand(operand)){
-		if (isValidJumpOperand(operand, firstJumpCheck))
-			/*operand is a jump operand*/
-			return JUMP;
-	}
-
-	if (isRegisterName(operand))
-		/*operand is a register*/
-		return DIRECT_REGISTER;
-
-	return NO_TYPE; /*Operand is not recognizable*/
-	}
-		
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/labels.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/constants.h"
+#include "headers/errors.h"
+#include "headers/stringUtils.h"
+#include "headers/operations.h"
+#include "headers/operands.h"
+#include "headers/lexer.h"
+
+
+/*Description: this file contains all functions and datatypes that have to do with getting and checking operands
+  of operations found in source code. The operands of a command are found and parsed from the tokens after its
+  operation name (see lexer.c), so the statement is not scanned again. No token after the operation name spans
+  whitespace or a comma, so an operand is a run of tokens that are not separated by whitespace.*/
+
+
+/*Receives the tokens of a statement and the index of a token, and returns 1 if the token starts right after the
+  token before it, without whitespace between them.*/
+static int isAdjacentToken(Token_Stream* tokens, int index){
+    Token* previous = &tokens->tokens[index - 1];
+    return tokens->tokens[index].offset == previous->offset + previous->length;
+}
+
+
+/*Receives the tokens of a statement and returns the index of the first token that starts at offset or after it,
+  tokenCount if there is none.*/
+static int findToken(Token_Stream* tokens, int offset){
+    int i = 0;
+    while (i < tokens->tokenCount && tokens->tokens[i].offset < offset)
+        i++;
+    return i;
+}
+
+
+/*Receives the tokens of a statement, an operand in it and a token type, and returns the index of the first token of
+  the type in the operand, -1 if there is none.*/
+static int findTokenOfType(Token_Stream* tokens, Text_Span text, Token_Type type){
+    int i;
+    for (i = findToken(tokens, text.offset); i < tokens->tokenCount && tokens->tokens[i].offset < text.offset + text.length; i++){
+        if (tokens->tokens[i].type == type)
+            return i;
+    }
+    return -1;
+}
+
+
+/*Receives the tokens of a statement and returns an empty operand after its last token, for an operand that is
+  missing.*/
+static Text_Span getMissingOperand(Token_Stream* tokens){
+    Token* last = &tokens->tokens[tokens->tokenCount - 1]; /*there is at least the operation name*/
+    Text_Span operand;
+    operand.offset = last->offset + last->length;
+    operand.length = 0;
+    return operand;
+}
+
+
+/*Receives the tokens of a statement and the index of a token, and returns the operand that starts with it: the token
+  and the tokens right after it, up to whitespace (or a comma if stopAtComma). The length of the span is 0 if the
+  token is a comma.*/
+static Text_Span getOperandFrom(Token_Stream* tokens, int first, int stopAtComma){
+    Text_Span operand;
+    int last = first;
+
+    if (first >= tokens->tokenCount)
+        return getMissingOperand(tokens);
+    operand.offset = tokens->tokens[first].offset;
+    operand.length = 0;
+    if (tokens->tokens[first].type == TOKEN_COMMA)
+        return operand;
+    while (last + 1 < tokens->tokenCount && isAdjacentToken(tokens, last + 1) && !(stopAtComma && tokens->tokens[last + 1].type == TOKEN_COMMA))
+        last++;
+    operand.length = tokens->tokens[last].offset + tokens->tokens[last].length - operand.offset;
+    return operand;
+}
+
+
+/*Returns the jump operand of the command that was lexed last: all of its tokens after the operation name. The length
+  of the span is 0 if no operand is found.*/
+Text_Span getJumpOperand(){
+    Token_Stream* tokens = getStatementTokens();
+    int first = tokens->keyword + 1;
+    Token* last = &tokens->tokens[tokens->tokenCount - 1];
+    Text_Span operand;
+
+    if (first >= tokens->tokenCount)
+        return getMissingOperand(tokens);
+    operand.offset = tokens->tokens[first].offset;
+    operand.length = last->offset + last->length - operand.offset;
+    return operand;
+}
+
+
+/*Returns the first operand of the command that was lexed last, the tokens right after its operation name up to
+  whitespace or a comma. The length of the span is 0 if no operand is found.*/
+Text_Span getSingleOperand(){
+    Token_Stream* tokens = getStatementTokens();
+    return getOperandFrom(tokens, tokens->keyword + 1, 1);
+}
+
+
+/*Returns the operand after the first comma of the command that was lexed last: it starts after the commas and ends
+  at whitespace, so it includes any commas after it. The length of the span is 0 if no operand is found.*/
+Text_Span getSecondOperand(){
+    Token_Stream* tokens = getStatementTokens();
+    int i = tokens->keyword + 1;
+
+    while (i < tokens->tokenCount && tokens->tokens[i].type != TOKEN_COMMA)
+        i++;
+    while (i < tokens->tokenCount && tokens->tokens[i].type == TOKEN_COMMA)
+        i++;
+    return getOperandFrom(tokens, i, 0);
+}
+
+
+/*Returns 1 if the command that was lexed last has parentheses after its operation name, so it may have a jump
+  operand, returns 0 otherwise.*/
+int isPossibleJumpOperand(){
+    Token_Stream* tokens = getStatementTokens();
+    int i;
+    for (i = tokens->keyword + 1; i < tokens->tokenCount; i++){
+        if (tokens->tokens[i].type == TOKEN_OPEN_PARENTHESIS || tokens->tokens[i].type == TOKEN_CLOSE_PARENTHESIS)
+            return 1;
+    }
+    return 0;
+}
+
+
+/*Receives the tokens of a statement and an operand in it whose span is set, and sets its assignment type (immediate
+  number, label or register, NO_TYPE if it is none of them) and its value: the number of an immediate operand or of
+  a register. Only an operand that is a single token has a type.*/
+static void classifyOperand(Token_Stream* tokens, Operand* operand){
+    int i = findToken(tokens, operand->text.offset);
+    Token* token = &tokens->tokens[i];
+
+    operand->type = NO_TYPE; /*Operand is not recognizable*/
+    operand->value = 0;
+    if (i == tokens->tokenCount || token->offset != operand->text.offset || token->length != operand->text.length)
+        return;
+    if (token->type == TOKEN_IMMEDIATE){
+        operand->type = IMMEDIATE;
+        operand->value = token->value;
+    }
+    else if (token->type == TOKEN_IDENTIFIER) /*not the name of an operation or a register*/
+        operand->type = DIRECT;
+    else if (token->type == TOKEN_REGISTER){
+        operand->type = DIRECT_REGISTER;
+        operand->value = token->value;
+    }
+}
+
+
+/*Receives a part of an operand, the offset of its first char and of the char after it, and sets the span of the
+  part.*/
+static void setOperandPart(Operand* part, int first, int end){
+    part->text.offset = first;
+    part->text.length = end - first;
+}
+
+
+/*Receives the tokens of a statement and a descriptor whose operand has parentheses, and parses the operand as a jump
+  operand: a label followed by a source and a destination operand within parentheses, label(source,destination). The
+  label and the operands within the parentheses are set in the descriptor, even if the operand is not valid, so that
+  they are encoded (and their labels are looked up) the same either way. Checks the syntax of the operand and raises
+  errors if needed. Returns JUMP if the operand is valid, NO_TYPE otherwise.*/
+static Assignment_Type parseJumpOperand(Token_Stream* tokens, Operand_Descriptor* descriptor){
+    Text_Span text = descriptor->operand.text;
+    int end = findToken(tokens, text.offset + text.length); /*index after the last token of the operand*/
+    int open = -1, comma = -1, close = -1; /*indexes of the tokens of label(source,destination)*/
+    int closed = 0; /*bool, the operand has a ')'*/
+    int parentheses = 0;
+    int covered = 0; /*length of the operand that is not whitespace*/
+    Token* token;
+    int i;
+
+    for (i = findToken(tokens, text.offset); i < end; i++){
+        token = &tokens->tokens[i];
+        covered += token->length;
+        if (token->type == TOKEN_OPEN_PARENTHESIS || token->type == TOKEN_CLOSE_PARENTHESIS)
+            parentheses++;
+        if (token->type == TOKEN_CLOSE_PARENTHESIS)
+            closed = 1;
+        if (token->type == TOKEN_OPEN_PARENTHESIS && open < 0)
+            open = i;
+        else if (token->type == TOKEN_COMMA && open >= 0 && comma < 0)
+            comma = i;
+        else if (token->type == TOKEN_CLOSE_PARENTHESIS && comma >= 0 && close < 0)
+            close = i;
+    }
+
+    if (comma >= 0){
+        setOperandPart(&descriptor->jumpSource, tokens->tokens[open].offset + 1, tokens->tokens[comma].offset);
+        setOperandPart(&descriptor->jumpDestination, tokens->tokens[comma].offset + 1, close >= 0 ? tokens->tokens[close].offset : text.offset + text.length);
+        classifyOperand(tokens, &descriptor->jumpSource);
+        classifyOperand(tokens, &descriptor->jumpDestination);
+    }
+    classifyOperand(tokens, &descriptor->jumpLabel);
+
+    if (parentheses > 2)
+        raiseTooManyParentheses();
+    if (open < 0 || !closed){
+        raiseMissingParenthesesInJumpOperand();
+        return NO_TYPE;
+    }
+    if (covered < text.length){
+        /*Should be no spaces in jump operand*/
+        raiseSpaceInJumpOperand();
+        return NO_TYPE;
+    }
+
+    if (close != end - 1)
+        return NO_TYPE; /*the operand should end with the ')' after the operands*/
+    if (descriptor->jumpLabel.type == NO_TYPE || descriptor->jumpSource.type == NO_TYPE || descriptor->jumpDestination.type == NO_TYPE){
+        /*One of the operands in the jump operand has invalid syntax*/
+        return NO_TYPE;
+    }
+    return JUMP;
+}
+
+
+/*Receives the span of an operand in the command that was lexed last (length 0 if the operand is missing), and parses
+  the operand once into the descriptor from its tokens: its assignment type and value and, for a jump operand, its
+  label and the source and destination operands within its parentheses. The label of the descriptor is the operand up
+  to its '(' (all of it if it has none). Syntax errors of a jump operand are raised here. Nothing is allocated: the
+  descriptor refers to the operand by its span in the statement.*/
+void parseOperand(Text_Span text, Operand_Descriptor* descriptor){
+    Token_Stream* tokens = getStatementTokens();
+    int open = findTokenOfType(tokens, text, TOKEN_OPEN_PARENTHESIS);
+
+    descriptor->operand.text = text;
+    setOperandPart(&descriptor->jumpLabel, text.offset, open >= 0 ? tokens->tokens[open].offset : text.offset + text.length);
+    setOperandPart(&descriptor->jumpSource, text.offset, text.offset);
+    setOperandPart(&descriptor->jumpDestination, text.offset, text.offset);
+    descriptor->jumpLabel.type = descriptor->jumpSource.type = descriptor->jumpDestination.type = NO_TYPE;
+    descriptor->jumpLabel.value = descriptor->jumpSource.value = descriptor->jumpDestination.value = 0;
+
+    classifyOperand(tokens, &descriptor->operand);
+    if (descriptor->operand.type == NO_TYPE && (open >= 0 || findTokenOfType(tokens, text, TOKEN_CLOSE_PARENTHESIS) >= 0))
+        descriptor->operand.type = parseJumpOperand(tokens, descriptor);
+}
@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "headers/constants.h"
+#include "headers/assembler.h"
+#include "headers/statements.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/labels.h"
+#include "headers/stringUtils.h"
+#include "headers/context.h"
+#include "headers/arena.h"
+#include "headers/lexer.h"
+
+
+/*Description: this file contains the parallel first pass, which is used for large sources when the first pass has
+  more than one job. The source is split into chunks of whole lines and the first pass is done in three phases:
+    1. sizing (parallel): every thread finds the type of each statement in its chunk and the number of words it
+       writes into the instruction and data arrays, based on its operation and the assignment types of its operands.
+    2. planning (serial): a prefix sum over the sizes gives every statement its IC and DC, and the labels,
+       entries and externals are entered into the tables of the file in the order of the source.
+    3. encoding (parallel): every thread encodes the statements of its chunk straight into their final place in
+       memory, using the same functions as the serial first pass.
+  Errors are only reported by the serial first pass. If any phase raises an error, or a statement was not the size
+  it was planned to be, everything is reset and the caller runs the serial first pass, so the output and the
+  messages are always the same as those of the serial first pass.*/
+
+
+/*A statement that writes words into memory, or declares a label, an entry or an external.*/
+typedef struct Planned_Statement{
+    size_t offset; /*index of the statement in the source*/
+    int lineNumber; /*line number in the chunk, and in the file after planning*/
+    Statement_type statementType;
+    Instruction_type instructionType;
+    int hasLabel; /*bool, the statement declares a label*/
+    int instructionWords; /*number of words the statement writes into the instruction array*/
+    int dataWords; /*number of words the statement writes into the data array*/
+    int IC; /*index of the first instruction word of the statement*/
+    int DC; /*index of the first data word of the statement*/
+} Planned_Statement;
+
+
+/*A part of the source (whole lines) that is sized and encoded by a single thread.*/
+typedef struct Source_Chunk{
+    const char* source;
+    size_t start; /*index of the first char of the chunk in the source*/
+    size_t end; /*index after the last char of the chunk*/
+    Planned_Statement* statements;
+    int statementCount;
+    int statementsSize;
+    int lineCount; /*number of lines in the chunk, counted the way the serial first pass counts them*/
+    int failed; /*bool, set when a statement raised an error or was not the size it was planned to be*/
+    Assembler_Context* context; /*context of the thread, its memory shares the arrays of the file*/
+} Source_Chunk;
+
+
+/*Diagnostics sink of the parallel first pass. Messages are not printed, the serial first pass will report them.*/
+static void flagDiagnostic(void* failed, const char* message){
+    (void)message;
+    *(int*)failed = 1;
+}
+
+
+/*Copies the line that starts at position into statement without its leading and trailing whitespace (a buffer of the
+  given size that is enlarged if needed, see copyTrimmedLine), sets the indentation of the statement in the current
+  context and returns the position of the next line.*/
+static size_t readStatement(const char* source, size_t end, size_t position, char** statement, size_t* statementSize){
+    const char* newLine = memchr(source + position, '\n', end - position);
+    size_t length = newLine == NULL ? end - position : (size_t)(newLine - (source + position)) + 1;
+    size_t nextPosition = position + length;
+    getCurrentContext()->statementIndent = countLeadingWhitespace(source + position, length);
+    *statement = copyTrimmedLine(*statement, statementSize, source + position, &length);
+    return nextPosition;
+}
+
+
+/*Adds a statement to the chunk and returns it. The statements array is enlarged dynamically.*/
+static Planned_Statement* addPlannedStatement(Source_Chunk* chunk){
+    if (chunk->statementCount >= chunk->statementsSize){
+        chunk->statementsSize = chunk->statementsSize * 2 + INITIAL_TABLE_SIZE;
+        chunk->statements = realloc(chunk->statements, chunk->statementsSize * sizeof(Planned_Statement));
+    }
+    return &chunk->statements[chunk->statementCount++];
+}
+
+
+/*Thread of the sizing phase. Finds the type and the size of every statement in the chunk.*/
+static void* sizeChunk(void* chunkPointer){
+    Source_Chunk* chunk = chunkPointer;
+    Planned_Statement* planned;
+    Statement_type statementType;
+    char* statement = NULL;
+    size_t statementSize = 0;
+    size_t position = chunk->start;
+    size_t offset;
+    Arena_Mark statementMark;
+
+    setCurrentContext(chunk->context);
+    statementMark = arenaMark();
+    while (position < chunk->end && !chunk->failed){
+        arenaRelease(statementMark); /*the operands and names of the previous statement are no longer needed*/
+        offset = position;
+        position = readStatement(chunk->source, chunk->end, position, &statement, &statementSize);
+        chunk->lineCount++;
+
+        statementType = getStatementType(statement);
+        if (statementType == EMPTY || statementType == COMMENT)
+            continue;
+        if (statementType == UNIDENTIFIED){
+            chunk->failed = 1;
+            break;
+        }
+
+        planned = addPlannedStatement(chunk);
+        planned->offset = offset;
+        planned->lineNumber = chunk->lineCount;
+        planned->statementType = statementType;
+        planned->instructionType = getCurrentInstructionType();
+        planned->hasLabel = isPossibleLabelDeclaration(statement);
+        planned->instructionWords = 0;
+        planned->dataWords = 0;
+
+        if (statementType == COMMAND)
+            planned->instructionWords = getCommandSize(statement);
+        else if (planned->instructionType == DATA)
+            planned->dataWords = getDataSize(statement);
+        else if (planned->instructionType == STRING)
+            planned->dataWords = getStringSize(statement);
+    }
+    arenaRelease(statementMark);
+    free(statement);
+    return NULL;
+}
+
+
+/*Planning phase, runs in the context of the file. Gives every statement its IC and DC and enters the labels, entries
+  and externals into the tables of the file in the order of the source. Returns 0 if the memory overflows.*/
+static int planMemory(Source_Chunk* chunks, int chunkCount){
+    Assembler_Context* context = getCurrentContext();
+    Planned_Statement* planned;
+    char* statement = NULL;
+    size_t statementSize = 0;
+    int IC = MEMORY_START;
+    int DC = 0;
+    int lineBase = 0; /*number of lines in the chunks before the current chunk*/
+    Arena_Mark statementMark = arenaMark();
+    int i, j;
+
+    for (i=0; i < chunkCount; i++){
+        for (j=0; j < chunks[i].statementCount; j++){
+            arenaRelease(statementMark);
+            planned = &chunks[i].statements[j];
+            planned->lineNumber += lineBase;
+            planned->IC = IC;
+            planned->DC = DC;
+
+            if (planned->hasLabel || (planned->statementType == INSTRUCTION && (planned->instructionType == EXTERN || planned->instructionType == ENTRY))){
+                readStatement(chunks[i].source, chunks[i].end, planned->offset, &statement, &statementSize);
+                context->lineNumber = planned->lineNumber;
+                setMemoryCounters(IC, DC);
+            }
+
+            if (planned->statementType == COMMAND && planned->hasLabel)
+                handleLabelDeclaration(statement, CODETAG);
+            if (planned->statementType == INSTRUCTION && planned->instructionType == EXTERN)
+                handleExternInstruction(statement);
+            if (planned->statementType == INSTRUCTION && planned->instructionType == ENTRY)
+                handleEntryInstruction(statement);
+            if (planned->statementType == INSTRUCTION && (planned->instructionType == DATA || planned->instructionType == STRING) && planned->hasLabel)
+                handleLabelDeclaration(statement, DATATAG);
+
+            IC += planned->instructionWords;
+            DC += planned->dataWords;
+        }
+        lineBase += chunks[i].lineCount;
+    }
+    setMemoryCounters(IC, DC);
+    context->lineNumber = lineBase + 1;
+    arenaRelease(statementMark);
+    free(statement);
+    return (IC + DC) <= getMemorySize(); /*same check as checkMemoryOverFlow*/
+}
+
+
+/*Thread of the encoding phase. Encodes every statement of the chunk into its planned place in memory.*/
+static void* encodeChunk(void* chunkPointer){
+    Source_Chunk* chunk = chunkPointer;
+    Planned_Statement* planned;
+    char* statement = NULL;
+    size_t statementSize = 0;
+    Arena_Mark statementMark;
+    int i;
+
+    setCurrentContext(chunk->context);
+    statementMark = arenaMark();
+    for (i=0; i < chunk->statementCount && !chunk->failed; i++){
+        arenaRelease(statementMark);
+        planned = &chunk->statements[i];
+        if (planned->statementType == INSTRUCTION && (planned->instructionType == EXTERN || planned->instructionType == ENTRY))
+            continue; /*entered into the tables while planning, nothing to encode*/
+
+        readStatement(chunk->source, chunk->end, planned->offset, &statement, &statementSize);
+        lexStatement(statement);
+        chunk->context->currentInstructionType = planned->instructionType; /*found while sizing*/
+        chunk->context->lineNumber = planned->lineNumber;
+        setMemoryCounters(planned->IC, planned->DC);
+
+        if (planned->statementType == COMMAND)
+            handleCommandStatement(statement);
+        else handleInstructionStatement(statement);
+
+        if (getIC() - planned->IC != planned->instructionWords || getDC() - planned->DC != planned->dataWords)
+            chunk->failed = 1;
+        if (planned->hasLabel)
+            /*the label of the file was entered while planning, the thread only needs an empty table*/
+            resetSymbolTable();
+    }
+    arenaRelease(statementMark);
+    free(statement);
+    return NULL;
+}
+
+
+/*Starts a thread for every chunk with the given function and waits for all of them. Returns 1 if any chunk failed.*/
+static int runOnChunks(Source_Chunk* chunks, int chunkCount, void* (*function)(void*)){
+    pthread_t* threads = malloc(chunkCount * sizeof(pthread_t));
+    int failed = 0;
+    int i;
+
+    for (i=0; i < chunkCount; i++)
+        pthread_create(&threads[i], NULL, function, &chunks[i]);
+    for (i=0; i < chunkCount; i++){
+        pthread_join(threads[i], NULL);
+        if (chunks[i].failed)
+            failed = 1;
+    }
+    free(threads);
+    return failed;
+}
+
+
+/*Receives the source code after the pre processor and carries out the first pass on jobCount threads, in the context
+  of the file. Returns 1 if successful. Returns 0 if an error was found, after resetting the memory and the tables,
+  and the caller should run the serial first pass on the source to report the errors.*/
+int parallelFirstPass(const char* source, size_t length, int jobCount){
+    Assembler_Context* context = getCurrentContext();
+    Diagnostics_Sink sink = context->sink;
+    void* sinkData = context->sinkData;
+    Source_Chunk* chunks = calloc(jobCount, sizeof(Source_Chunk));
+    size_t start = 0;
+    size_t end;
+    int failed;
+    int i;
+
+    for (i=0; i < jobCount; i++){
+        end = (i == jobCount - 1) ? length : (length / jobCount) * (i + 1);
+        if (end < start)
+            end = start;
+        while (end > 0 && end < length && source[end - 1] != '\n')
+            end++; /*chunks end after a new line*/
+
+        chunks[i].source = source;
+        chunks[i].start = start;
+        chunks[i].end = end;
+        chunks[i].context = createContext(flagDiagnostic, &chunks[i].failed);
+        chunks[i].context->currentFileName = context->currentFileName;
+        setCurrentContext(chunks[i].context);
+        initSymbolTable();
+        initEntriesArray();
+        shareMemory(context->memory);
+        start = end;
+    }
+    setCurrentContext(context);
+
+    failed = runOnChunks(chunks, jobCount, sizeChunk);
+    if (!failed){
+        context->sink = flagDiagnostic;
+        context->sinkData = &failed;
+        if (!planMemory(chunks, jobCount))
+            failed = 1;
+        else reserveMemory();
+        context->sink = sink;
+        context->sinkData = sinkData;
+    }
+    if (!failed)
+        failed = runOnChunks(chunks, jobCount, encodeChunk);
+    if (!failed){
+        for (i=0; i < jobCount; i++)
+            takeFixups(chunks[i].context->memory);
+    }
+
+    for (i=0; i < jobCount; i++){
+        setCurrentContext(chunks[i].context);
+        freeSymbolTable();
+        freeEntriesArray();
+        freeMemory();
+        freeContext(chunks[i].context);
+        free(chunks[i].statements);
+    }
+    setCurrentContext(context);
+    free(chunks);
+
+    if (failed){
+        /*start over, so the serial first pass finds and reports the errors in order*/
+        resetSymbolTable();
+        resetEntriesArray();
+        resetMemory();
+        initIC();
+        initDC();
+        context->outputStatus = 1;
+        context->outputEntries = 0;
+        context->outputExterns = 0;
+        context->lineNumber = 1;
+        return 0;
+    }
+    return 1;
+}
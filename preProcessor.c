@@ -1,168 +1,479 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-#include "headers/constants.h"
-#include "headers/stringUtils.h"
-#include "headers/errors.h"
-#include "headers/operations.h"
-#include "headers/assembler.h"
-#include "headers/errors.h"
-#include "headers/memory.h"
-#include "headers/macros.h"
-
-
-/*Description: This file is dedicated to the pre processing stage of the assembler where macros are found in the source code and 
-  the source code is copied to an output file without the macro declarations as well as replacing any reference
-  to a macro in the source code with the code of the macro.*/
-
-
-static int lineNumber;
-static char* currentFileName;
-
-/*Gets the name of the current file being iterated through.*/
-char* getPreProcessorFileName(){
-    return currentFileName;
-}
-
-
-/*Gets current line number of the source file.*/
-int getPreProcessorLineNumber(){
-    return lineNumber;
-}
-
-/*Used to close source and output files as well as delete the outputfile if there is an error during the 
-  preProcessor phase.*/
-void breakPreProcessor(FILE* sourceFile, FILE* outputFile, char* outputFilePath){
-    fclose(sourceFile);
-    fclose(outputFile);
-    remove(outputFilePath);
-}
-
-
-/*Checks if there are extra tokens at the end of a macro declaration or at the end of a macro. endMacro variable
-  acts as a boolean that tells the function whether to check for the error at the macro declaration or at the end of a macro.*/
-int checkForExtraTokensInMacro(char** splitLine, int endMacro){
-    if (endMacro && splitLine[1] != NULL){
-        /*A valid end of macro should consist of only one token in the array*/
-        raiseExtraMacroTokens(endMacro);
-        return 0;
-    }
-    if (!endMacro && splitLine[2] != NULL){
-        /*A valid end of macro should consist of only two tokens in the array*/
-        raiseExtraMacroTokens(endMacro);
-        return 0;
-    }
-    return 1; 
-}
-
-
-/*This function receives a string which supposed to be a path to a source file and the macroTable. If it is able to open the file,
-  the function iterates through the file line by line looking for a macro declaration. It then stores the macros and their 
-  respective code in the macro table while deleting the macro declaration from the file as well as replacing references 
-  to a macro's name with the appropriate code.*/
-int preProcessor(char* fileName){
-    FILE *sourceFile, *outputFile;
-    char** splitLine; /*Will hold the current line of code split by whitespace*/
-    char* firstToken; /*Holds the first token of the current line in file*/
-    char* macroName = ""; /*The name of the macro if it is found in code*/
-    char* sourceFilePath = malloc((strlen(fileName)  + strlen(SOURCE_FILETYPE)) * sizeof(char) + 1);
-    char* outputFilePath = malloc((strlen(fileName)  + strlen(POST_PREPROCESSOR_FILETYPE)) * sizeof(char) + 1);
-
-    char* macroContents = malloc(sizeof(char)); /*Will hold the contents of a certain macro*/
-    int isMacro = 0; /*Acts as boolean flag that symbolizes if currently iterating through a macro*/
-    int writeLineToOutput = 1; /*Acts as boolean flag that tells the program to write a line to output file or not*/
-    char line[MAX_STATEMENT_LENGTH + 1];
-    lineNumber = 1;
-    currentFileName = fileName;
-    
-    sprintf(sourceFilePath, "%s%s", fileName, SOURCE_FILETYPE);
-    sprintf(outputFilePath, "%s%s", fileName, POST_PREPROCESSOR_FILETYPE);
-    sourceFile = fopen(sourceFilePath, "r");
-    outputFile = fopen(outputFilePath, "w"); /*Creating am file to be written to.*/
-
-     if (sourceFile == NULL){
-        raiseFileNotFound(fileName);
-		fclose(outputFile);
-		remove(outputFilePath);
-        return 0;
-
-    }
-
-    /*This section iterates through source file line by line, finds macros and writes code to the output file, skipping over
-      macro declarations and replacing references to macros in the source file with their code in the output file.*/
-    while (fgets(line, MAX_STATEMENT_LENGTH, sourceFile) != NULL){
-        trimWhitespace(line);
-
-        if (strlen(line) == 1 && line[0] == '\n'){
-            /*Found empty line, can skip to next iteration*/
-            lineNumber++;
-            continue;
-        }
-
-        splitLine = splitLineByWhitespace(line);
-        firstToken = splitLine[0];
-        writeLineToOutput = 1;
-
-        if (isMacro){
-            writeLineToOutput = 0;
-            if (strcmp(firstToken, END_MACRO_ID) == 0){
-                /*Reached end of macro declaration*/
-                if (checkForExtraTokensInMacro(splitLine, 1) != 0 && isValidMacroName(macroName) != 0){
-                    /*There are no extra tokens at the end of the macro and the macro name is valid*/
-                    /*store the macro ID and contents in macroTable*/
-                   /*htInsert(macroTable, macroName, macroContents);*/
-                   
-                    enterMacro(macroName, macroContents);
-                    isMacro = 0; /*no longer iterating through macro*/
-                }
-                else{
-                    /*Too many extra tokens at the end of the macro or invalid macro name*/
-                    breakPreProcessor(sourceFile, outputFile, outputFilePath);
-                    break;
-                }
-            }
-            else{
-                /*Reallocate memory for contents of the current macro*/
-                macroContents = realloc(macroContents, strlen(macroContents) + strlen(line) + 1);
-                strcat(macroContents, line); /*current line is added to the current macro*/
-            }
-        }
-
-        if (getMacroContents(firstToken) != NULL){
-            /*Found reference to a known macro ID, write the macroContents from macroTable to output file*/
-            writeLineToOutput = 0;
-            fputs(getMacroContents(firstToken), outputFile);
-        }
-
-        if (strcmp(firstToken, MACRO_ID) == 0){
-            /*A macro declaration has been found*/
-            if (checkForExtraTokensInMacro(splitLine, 0) != 0){
-                /*There are no extra tokens in the macro declaration line*/
-                isMacro = 1;
-                writeLineToOutput = 0;
-                macroName = splitLine[1]; /*The name of the macro is the next token in the line*/
-                macroContents[0] = '\0'; /*Reset macroContents*/
-            }
-            else{
-                /*There are too many tokens in the macro declaration*/
-                breakPreProcessor(sourceFile, outputFile, outputFilePath);
-                break;
-            }
-        }
-        
-        if (writeLineToOutput)
-            fputs(line, outputFile);
-
-        free(splitLine);
-        lineNumber++;
-    }
-    
-    /*Free all dynamically allocated memory and close files.*/
-    free(sourceFilePath);
-    free(outputFilePath);
-    free(macroContents);
-    fclose(sourceFile);
-    fclose(outputFile);
-    return 1;
-}
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "headers/constants.h"
+#include "headers/stringUtils.h"
+#include "headers/errors.h"
+#include "headers/operations.h"
+#include "headers/assembler.h"
+#include "headers/errors.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/macros.h"
+#include "headers/context.h"
+#include "headers/preProcessor.h"
+#include "headers/lineStream.h"
+#include "headers/includes.h"
+#include "headers/sourceIndex.h"
+#include "headers/arena.h"
+
+
+/*Description: This file is dedicated to the pre processing stage of the assembler where macros are found in the source code and 
+  the source code is copied to an output file without the macro declarations as well as replacing any reference
+  to a macro in the source code with the code of the macro. A line include "name" is replaced with the output of
+  name.as, and the macros of name.as are declared as well.*/
+
+
+/*Gets the name of the current file being iterated through.*/
+char* getPreProcessorFileName(){
+    return getCurrentContext()->preProcessorFileName;
+}
+
+
+/*Gets current line number of the source file.*/
+int getPreProcessorLineNumber(){
+    return getCurrentContext()->preProcessorLineNumber;
+}
+
+/*Checks if there are extra tokens at the end of a macro declaration or at the end of a macro, given the number of
+  words in the line. endMacro variable acts as a boolean that tells the function whether to check for the error at the
+  macro declaration or at the end of a macro.*/
+int checkForExtraTokensInMacro(int wordCount, int endMacro){
+    if (endMacro && wordCount > 1){
+        /*A valid end of macro should consist of only one token in the array*/
+        raiseExtraMacroTokens(endMacro);
+        return 0;
+    }
+    if (!endMacro && wordCount > 2){
+        /*A valid end of macro should consist of only two tokens in the array*/
+        raiseExtraMacroTokens(endMacro);
+        return 0;
+    }
+    return 1; 
+}
+
+
+typedef enum {PRE_PROCESSOR_RUNNING, PRE_PROCESSOR_DONE, PRE_PROCESSOR_FAILED} Pre_Processor_Status;
+
+
+/*State of the pre processor of a single source, which is read one line at a time by expandNextLine.*/
+typedef struct Pre_Processor{
+    Source_Index* source;
+    int nextLine; /*number of the next line of source*/
+    char* line; /*trimmed copy of the current line of the source*/
+    size_t lineSize;
+    char* macroName; /*The name of the macro if it is found in code*/
+    char* macroParameters; /*the parameter list that follows the name of the macro, without the '\n'*/
+    int isMacro; /*Acts as boolean flag that symbolizes if currently iterating through a macro*/
+    Pre_Processor_Status status;
+    struct Pre_Processor* includer; /*pre processor of the file that includes this one, NULL for the source itself*/
+    File_Stamp stamp; /*identity of the file, to find files that include themselves*/
+    Include_Dependencies dependencies; /*files this file includes, directly or through other files*/
+    char* includeOutput; /*output of the last included file*/
+    size_t includeOutputLength;
+} Pre_Processor;
+
+
+/*Receives the name of the source file and the index of its source code and creates a pre processor for it.*/
+Pre_Processor* createPreProcessor(char* fileName, Source_Index* source){
+    Assembler_Context* context = getCurrentContext();
+    Pre_Processor* preProcessor = malloc(sizeof(Pre_Processor));
+    preProcessor->source = source;
+    preProcessor->nextLine = 0;
+    preProcessor->line = NULL;
+    preProcessor->lineSize = 0;
+    preProcessor->macroName = "";
+    preProcessor->macroParameters = NULL;
+    preProcessor->isMacro = 0;
+    preProcessor->status = PRE_PROCESSOR_RUNNING;
+    preProcessor->includer = NULL;
+    preProcessor->stamp.device = source->device;
+    preProcessor->stamp.inode = source->inode;
+    preProcessor->dependencies.files = NULL;
+    preProcessor->dependencies.count = 0;
+    preProcessor->dependencies.size = 0;
+    preProcessor->includeOutput = NULL;
+    preProcessor->includeOutputLength = 0;
+    context->preProcessorLineNumber = 1;
+    context->preProcessorFileName = fileName;
+    return preProcessor;
+}
+
+
+/*Returns 1 if the pre processor reached the end of the source without errors, 0 otherwise.*/
+int preProcessorSucceeded(Pre_Processor* preProcessor){
+    return preProcessor->status == PRE_PROCESSOR_DONE;
+}
+
+
+/*Frees a pre processor. The files that the source included are moved to the included files of the context, if it
+  collects them (see watch mode).*/
+void freePreProcessor(Pre_Processor* preProcessor){
+    Include_Dependencies* includedFiles = getCurrentContext()->includedFiles;
+
+    if (preProcessor->includer == NULL && includedFiles != NULL){
+        freeIncludeDependencies(includedFiles);
+        *includedFiles = preProcessor->dependencies;
+        preProcessor->dependencies.files = NULL;
+        preProcessor->dependencies.count = preProcessor->dependencies.size = 0;
+    }
+    free(preProcessor->line);
+    free(preProcessor->macroParameters);
+    free(preProcessor->includeOutput);
+    freeIncludeDependencies(&preProcessor->dependencies);
+    free(preProcessor);
+}
+
+
+/*Receives a macro declaration line (trimmed, starting with the macro ID) and returns a newly allocated copy of the
+  text that follows the macro name, without the '\n'.*/
+static char* copyMacroParameters(char* line){
+    char* parameters = line + strlen(MACRO_ID);
+    char* copy;
+    size_t length;
+
+    while (*parameters == ' ' || *parameters == '\t')
+        parameters++;
+    while (*parameters != ' ' && *parameters != '\t' && *parameters != '\n' && *parameters != '\0')
+        parameters++; /*skips the macro name*/
+    length = strcspn(parameters, "\n");
+    copy = malloc(length + 1);
+    memcpy(copy, parameters, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+
+/*Receives the name of a file (without the .as ending) that is included by the source of preProcessor and pre
+  processes it on its own, with a macro table of its own. Returns the result, which can be stored in the include
+  cache, or NULL if the file could not be pre processed.*/
+static struct Parsed_Include* parseIncludedFile(Pre_Processor* includer, char* fileName, File_Stamp* stamp){
+    Assembler_Context* context = getCurrentContext();
+    struct Macro_Table* includerMacros = context->macroTable;
+    char* includerFileName = context->preProcessorFileName;
+    int includerLineNumber = context->preProcessorLineNumber;
+    char* sourceFilePath = malloc((strlen(fileName) + strlen(SOURCE_FILETYPE)) * sizeof(char) + 1);
+    Pre_Processor* preProcessor;
+    Source_Index* source;
+    FILE* outputStream;
+    char* output = NULL;
+    size_t outputLength = 0, length;
+    const char* text;
+    struct Parsed_Include* result = NULL;
+
+    sprintf(sourceFilePath, "%s%s", fileName, SOURCE_FILETYPE);
+    source = openSourceIndex(sourceFilePath);
+    free(sourceFilePath);
+    if (source == NULL){
+        raiseIncludeNotFound(fileName);
+        return NULL;
+    }
+
+    initMacroTable();
+    preProcessor = createPreProcessor(fileName, source);
+    preProcessor->includer = includer;
+    preProcessor->stamp = *stamp;
+    addIncludeDependency(&preProcessor->dependencies, fileName, stamp);
+    outputStream = open_memstream(&output, &outputLength);
+    while ((text = expandNextLine(preProcessor, &length)) != NULL)
+        fwrite(text, 1, length, outputStream);
+    fclose(outputStream);
+
+    if (preProcessorSucceeded(preProcessor))
+        result = createParsedInclude(fileName, &preProcessor->dependencies, output, outputLength);
+
+    freePreProcessor(preProcessor);
+    freeMacroTable();
+    freeSourceIndex(source);
+    free(output);
+    context->macroTable = includerMacros;
+    context->preProcessorFileName = includerFileName;
+    context->preProcessorLineNumber = includerLineNumber;
+    return result;
+}
+
+
+/*Receives the name of a file (without the .as ending) that an include directive in the source of preProcessor
+  refers to and includes it: its macros are entered into the macro table and its output is kept in includeOutput.
+  The file is pre processed only the first time it is included in a batch, or when it changed since. A file that
+  keeps changing while it is pre processed is used as it was read the last time, without storing it in the cache.
+  Returns 1 if successful, 0 otherwise (after raising an error).*/
+static int includeFile(Pre_Processor* preProcessor, char* fileName){
+    File_Stamp includers[MAX_INCLUDE_DEPTH];
+    File_Stamp stamp;
+    Pre_Processor* includer;
+    struct Parsed_Include* include;
+    int includerCount = 0, attempts = 0, status, i;
+
+    for (includer = preProcessor; includer != NULL; includer = includer->includer){
+        if (includerCount == MAX_INCLUDE_DEPTH){
+            raiseIncludeDepth();
+            return 0;
+        }
+        includers[includerCount++] = includer->stamp;
+    }
+    if (!getFileStamp(fileName, &stamp)){
+        raiseIncludeNotFound(fileName);
+        return 0;
+    }
+    for (i=0; i < includerCount; i++){
+        if (isSameFile(&stamp, &includers[i])){
+            raiseIncludeCycle(fileName);
+            return 0;
+        }
+    }
+
+    while ((status = includeFromCache(fileName, includers, includerCount, &preProcessor->dependencies,
+        &preProcessor->includeOutput, &preProcessor->includeOutputLength)) == 0){
+        /*not parsed yet in this batch, or changed since*/
+        if ((include = parseIncludedFile(preProcessor, fileName, &stamp)) == NULL)
+            return 0;
+        if (++attempts == MAX_INCLUDE_ATTEMPTS){
+            status = includeParsed(include, includers, includerCount, &preProcessor->dependencies,
+                &preProcessor->includeOutput, &preProcessor->includeOutputLength);
+            freeParsedInclude(include);
+            break;
+        }
+        storeParsedInclude(include);
+        if (!getFileStamp(fileName, &stamp)){
+            raiseIncludeNotFound(fileName);
+            return 0;
+        }
+    }
+    return status > 0;
+}
+
+
+/*Expands the next line of the source, see expandNextLine. Only the name of a macro declaration is allocated from
+  the arena, other lines are expanded without allocating.*/
+static const char* expandLine(Pre_Processor* preProcessor, size_t* length){
+    Assembler_Context* context = getCurrentContext();
+    Text_Span words[3]; /*the first words of the current line, the rest are only counted*/
+    int wordCount;
+    char* macroName; /*the name that follows a macro declaration*/
+    const char* macroBody; /*body of the macro that the first token refers to*/
+    size_t macroBodyLength;
+    int macroStatus; /*1 if the first token is a macro, 0 if it is not, -1 if the macro can not be expanded*/
+    const char* sourceLine;
+    size_t sourceLineLength;
+    char* line;
+    char* includedFileName;
+    const char* output; /*text that the line expands to*/
+
+    if (preProcessor->status != PRE_PROCESSOR_RUNNING)
+        return NULL;
+    sourceLine = getSourceLine(preProcessor->source, preProcessor->nextLine++, &sourceLineLength);
+    if (sourceLine == NULL){
+        preProcessor->status = PRE_PROCESSOR_DONE;
+        return NULL;
+    }
+    line = preProcessor->line = copyTrimmedLine(preProcessor->line, &preProcessor->lineSize, sourceLine, &sourceLineLength);
+    output = line;
+
+    if (sourceLineLength == 1){
+        /*Found empty line, can skip to next line*/
+        context->preProcessorLineNumber++;
+        *length = 0;
+        return "";
+    }
+    *length = sourceLineLength;
+
+    wordCount = splitLineSpans(line, words, 3);
+    if (wordCount == 0)
+        words[0].offset = words[0].length = 0; /*a line of other whitespace, which is not a keyword*/
+
+    if (preProcessor->isMacro){
+        output = "";
+        *length = 0;
+        if (isSpanText(line, words[0], END_MACRO_ID)){
+            /*Reached end of macro declaration*/
+            if (checkForExtraTokensInMacro(wordCount, 1) != 0 && isValidMacroName(preProcessor->macroName) != 0){
+                /*There are no extra tokens at the end of the macro and the macro name is valid*/
+                /*store the macro ID and contents in macroTable, the same lookup finds a macro that is defined twice*/
+                if (!enterMacro(preProcessor->macroName, preProcessor->macroParameters)){
+                    raiseMacroRedefinition(preProcessor->macroName);
+                    preProcessor->status = PRE_PROCESSOR_FAILED;
+                    return NULL;
+                }
+                if (!checkMacroCycle(preProcessor->macroName)){
+                    /*the macro refers to itself, which is reported here even if it is never referenced*/
+                    preProcessor->status = PRE_PROCESSOR_FAILED;
+                    return NULL;
+                }
+                preProcessor->isMacro = 0; /*no longer iterating through macro*/
+            }
+            else{
+                /*Too many extra tokens at the end of the macro or invalid macro name*/
+                preProcessor->status = PRE_PROCESSOR_FAILED;
+                return NULL;
+            }
+        }
+        else
+            appendMacroBody(line, sourceLineLength); /*current line is added to the current macro*/
+    }
+
+    if (isSpanText(line, words[0], MACRO_ID)){
+        /*A macro declaration has been found, the name of the macro may be followed by its parameters*/
+        macroName = NULL;
+        if (wordCount < 2)
+            raiseMissingMacroName();
+        else{
+            macroName = arenaCopy(line + words[1].offset, words[1].length); /*The name of the macro is the next word in the line*/
+            free(preProcessor->macroParameters);
+            preProcessor->macroParameters = copyMacroParameters(line);
+        }
+        if (macroName != NULL && checkMacroParameters(macroName, preProcessor->macroParameters)){
+            preProcessor->isMacro = 1;
+            output = "";
+            *length = 0;
+            preProcessor->macroName = internString(macroName);
+            beginMacroBody();
+        }
+        else{
+            /*There is no macro name or the parameters are invalid*/
+            preProcessor->status = PRE_PROCESSOR_FAILED;
+            return NULL;
+        }
+    }
+
+    if (isSpanText(line, words[0], INCLUDE_ID) && !preProcessor->isMacro){
+        /*An include directive, the line is replaced with the output of the included file*/
+        includedFileName = getIncludedFileName(line, context->preProcessorFileName);
+        if (includedFileName == NULL)
+            raiseInvalidInclude();
+        if (includedFileName == NULL || !includeFile(preProcessor, includedFileName)){
+            free(includedFileName);
+            preProcessor->status = PRE_PROCESSOR_FAILED;
+            return NULL;
+        }
+        free(includedFileName);
+        context->preProcessorLineNumber++;
+        *length = preProcessor->includeOutputLength;
+        return preProcessor->includeOutput;
+    }
+
+    /*references inside a macro declaration are expanded when the macro is*/
+    macroStatus = preProcessor->isMacro ? 0 : expandMacro(line, &macroBody, &macroBodyLength);
+    if (macroStatus < 0){
+        /*Wrong arguments or the macro refers to itself*/
+        preProcessor->status = PRE_PROCESSOR_FAILED;
+        return NULL;
+    }
+    if (macroStatus > 0){
+        /*Found reference to a known macro ID, the line is replaced with the expanded body of the macro*/
+        output = macroBody;
+        *length = macroBodyLength;
+    }
+
+    context->preProcessorLineNumber++;
+    return output;
+}
+
+
+/*Reads the next line of the source and looks for a macro declaration in it. Macros and their respective code are stored
+  in the macro table, macro declarations are deleted from the output and references to a macro's name are replaced with
+  the code of the macro (in which references to other macros are expanded as well). Returns the text the line
+  expands to and sets length to its length (0 if the line is not part of the output), or returns NULL at the end of
+  the source or if there is an error in a macro declaration or a recursive macro (see preProcessorSucceeded). The text is not terminated and is valid until the next call.*/
+const char* expandNextLine(Pre_Processor* preProcessor, size_t* length){
+    Arena_Mark lineMark = arenaMark();
+    const char* output = expandLine(preProcessor, length);
+    arenaRelease(lineMark); /*the name of a macro declaration is not needed once it is interned*/
+    return output;
+}
+
+
+/*This function receives the name of the source file, the index of its source code and the stream the output should be
+  written to, and writes every line of the source to the output as expandNextLine expands it. 
+  Returns 1 if successful, 0 if there is an error in a macro declaration.*/
+int preProcessorFromSource(char* fileName, Source_Index* source, FILE* outputFile){
+    Pre_Processor* preProcessor = createPreProcessor(fileName, source);
+    const char* output;
+    size_t length;
+    int result;
+
+    while ((output = expandNextLine(preProcessor, &length)) != NULL)
+        fwrite(output, 1, length, outputFile);
+
+    result = preProcessorSucceeded(preProcessor);
+    freePreProcessor(preProcessor);
+    return result;
+}
+
+
+/*Receives the name of a source file (without the .as ending) and makes the index of its lines the source index of the
+  current context, where the error messages of the file find it as well. Returns the index, or NULL if the file
+  cannot be opened (the error is raised).*/
+static Source_Index* indexSourceFile(char* fileName){
+    Assembler_Context* context = getCurrentContext();
+    char* sourceFilePath = malloc((strlen(fileName)  + strlen(SOURCE_FILETYPE)) * sizeof(char) + 1);
+
+    sprintf(sourceFilePath, "%s%s", fileName, SOURCE_FILETYPE);
+    if (context->sourceIndex != NULL)
+        freeSourceIndex(context->sourceIndex);
+    context->sourceIndex = openSourceIndex(sourceFilePath);
+    free(sourceFilePath);
+    if (context->sourceIndex == NULL)
+        raiseFileNotFound(fileName);
+    return context->sourceIndex;
+}
+
+
+/*This function receives a string which supposed to be a path to a source file. If it is able to open the file,
+  the .am file is created and the source file is pre processed into it. If there is an error during the
+  preProcessor phase, the .am file is deleted. Returns 1 if successful, 0 otherwise.*/
+int preProcessor(char* fileName){
+    Source_Index* source;
+    FILE* outputFile;
+    int result;
+    char* outputFilePath;
+
+    if ((source = indexSourceFile(fileName)) == NULL)
+        return 0;
+    outputFilePath = malloc((strlen(fileName)  + strlen(POST_PREPROCESSOR_FILETYPE)) * sizeof(char) + 1);
+    sprintf(outputFilePath, "%s%s", fileName, POST_PREPROCESSOR_FILETYPE);
+    outputFile = fopen(outputFilePath, "w"); /*Creating am file to be written to.*/
+
+    result = preProcessorFromSource(fileName, source, outputFile);
+
+    fclose(outputFile);
+    if (result == 0)
+        remove(outputFilePath);
+    free(outputFilePath);
+    return result;
+}
+
+
+/*This function receives a string which supposed to be a path to a source file. If it is able to open the file, the
+  pre processor runs as the source of the first pass, which reads the expanded lines as they are produced. The .am
+  file is only written if writeExpandedSource is set, and it is deleted if there is an error during the
+  preProcessor phase. Returns 1 if the pre processor was successful and the second pass can follow, 0 otherwise.*/
+int preProcessorToFirstPass(char* fileName, int writeExpandedSource){
+    Source_Index* source;
+    FILE* outputFile = NULL;
+    Line_Stream lines;
+    int result;
+    char* outputFilePath;
+
+    if ((source = indexSourceFile(fileName)) == NULL)
+        return 0;
+    outputFilePath = malloc((strlen(fileName)  + strlen(POST_PREPROCESSOR_FILETYPE)) * sizeof(char) + 1);
+    sprintf(outputFilePath, "%s%s", fileName, POST_PREPROCESSOR_FILETYPE);
+    if (writeExpandedSource)
+        outputFile = fopen(outputFilePath, "w"); /*Creating am file to be written to.*/
+
+    initPreProcessorLineStream(&lines, fileName, source, outputFile);
+    firstPassFromLineStream(fileName, &lines);
+    result = closeLineStream(&lines);
+
+    if (outputFile != NULL){
+        fclose(outputFile);
+        if (result == 0)
+            remove(outputFilePath);
+    }
+    free(outputFilePath);
+    return result;
+}
@@ -0,0 +1,9 @@
+; operands that repeat a label or another operand of the statement
+.entry L3
+L3: 	inc 	L3
+X: 	cmp 	#1, #2
+	mov 	r1, r1
+	prn 	X
+J: 	jmp 	J
+	bne 	L3(X,X)
+END: 	stop
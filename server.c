@@ -0,0 +1,273 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "headers/constants.h"
+#include "headers/includes.h"
+#include "headers/libassembler.h"
+#include "headers/socketUtils.h"
+
+
+/*Description: this file contains the assembler server (main --serve <socket>). The server keeps running and assembles
+  the files it is asked to over a unix socket, replying with the outputs and the diagnostics. Every connection is
+  handled by its own thread, which takes an idle session so that the tables of earlier requests are reused instead
+  of being allocated for each file. On shutdown the server stops reading from the open connections and waits for their
+  threads to finish before it frees the sessions.*/
+
+
+static Assembler_Session** idleSessions; /*sessions that are not used by any connection*/
+static int idleSessionCount;
+static int idleSessionsSize;
+static pthread_mutex_t sessionsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int* openConnections; /*sockets of the connections whose threads have not finished*/
+static int openConnectionCount;
+static int openConnectionsSize;
+static pthread_mutex_t connectionsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t connectionClosed = PTHREAD_COND_INITIALIZER;
+
+static int serverSocket;
+static volatile int shuttingDown; /*bool that is set by a shutdown request*/
+
+
+/*Returns an idle session, or a new one if all sessions are being used.*/
+static Assembler_Session* takeSession(){
+    Assembler_Session* session = NULL;
+    pthread_mutex_lock(&sessionsLock);
+    if (idleSessionCount > 0)
+        session = idleSessions[--idleSessionCount];
+    pthread_mutex_unlock(&sessionsLock);
+
+    if (session == NULL)
+        session = createAssemblerSession();
+    return session;
+}
+
+
+/*Returns a session to the idle sessions so that the next connection can reuse it.*/
+static void returnSession(Assembler_Session* session){
+    pthread_mutex_lock(&sessionsLock);
+    if (idleSessionCount >= idleSessionsSize){
+        idleSessionsSize += INITIAL_TABLE_SIZE;
+        idleSessions = realloc(idleSessions, idleSessionsSize * sizeof(Assembler_Session*));
+    }
+    idleSessions[idleSessionCount++] = session;
+    pthread_mutex_unlock(&sessionsLock);
+}
+
+
+/*Adds the socket of a connection to the open connections.*/
+static void addOpenConnection(int connection){
+    pthread_mutex_lock(&connectionsLock);
+    if (openConnectionCount >= openConnectionsSize){
+        openConnectionsSize += INITIAL_TABLE_SIZE;
+        openConnections = realloc(openConnections, openConnectionsSize * sizeof(int));
+    }
+    openConnections[openConnectionCount++] = connection;
+    pthread_mutex_unlock(&connectionsLock);
+}
+
+
+/*Removes the socket of a connection from the open connections once its thread no longer uses a session.*/
+static void removeOpenConnection(int connection){
+    int i;
+    pthread_mutex_lock(&connectionsLock);
+    for (i=0; i < openConnectionCount; i++){
+        if (openConnections[i] == connection){
+            openConnections[i] = openConnections[--openConnectionCount];
+            break;
+        }
+    }
+    pthread_cond_signal(&connectionClosed);
+    pthread_mutex_unlock(&connectionsLock);
+}
+
+
+/*Stops reading requests from the open connections, so that their threads finish once they have replied to the
+  request they are handling, and waits for all of them to finish.*/
+static void closeOpenConnections(){
+    int i;
+    pthread_mutex_lock(&connectionsLock);
+    for (i=0; i < openConnectionCount; i++)
+        shutdown(openConnections[i], SHUT_RD);
+    while (openConnectionCount > 0)
+        pthread_cond_wait(&connectionClosed, &connectionsLock);
+    free(openConnections);
+    openConnections = NULL;
+    openConnectionsSize = 0;
+    pthread_mutex_unlock(&connectionsLock);
+}
+
+
+/*Sends the output of a request: the result line, a section for each output that exists and the end line.*/
+static int sendOutput(int connection, Assembly_Output* output){
+    char result[MAX_REQUEST_LINE_LENGTH];
+    sprintf(result, "%s %d\n", RESPONSE_RESULT, output->success);
+
+    if (!writeSocketBytes(connection, result, strlen(result)))
+        return 0;
+    if (output->expandedSource != NULL && !writeSocketSection(connection, "am", output->expandedSource, output->expandedSourceLength))
+        return 0;
+    if (output->objects != NULL && !writeSocketSection(connection, "ob", output->objects, output->objectsLength))
+        return 0;
+    if (output->externs != NULL && !writeSocketSection(connection, "ext", output->externs, output->externsLength))
+        return 0;
+    if (output->entries != NULL && !writeSocketSection(connection, "ent", output->entries, output->entriesLength))
+        return 0;
+    if (output->diagnostics != NULL && !writeSocketSection(connection, "diagnostics", output->diagnostics, output->diagnosticsLength))
+        return 0;
+    return writeSocketBytes(connection, RESPONSE_END "\n", strlen(RESPONSE_END) + 1);
+}
+
+
+/*Receives an output and an error message and makes the output a failed reply that holds only the message.*/
+static void setRequestError(Assembly_Output* output, const char* message){
+    output->success = 0;
+    output->diagnostics = malloc(MAX_REQUEST_LINE_LENGTH);
+    sprintf(output->diagnostics, "%s", message);
+    output->diagnosticsLength = strlen(output->diagnostics);
+}
+
+
+/*Receives a request line and carries out the request with the given session, filling output.
+  Returns 0 if the connection should be closed, 1 if the output should be sent, and 2 if the output should be sent
+  and the connection closed after it (the source of a rejected SOURCE request can not be skipped).*/
+static int handleRequest(Assembler_Session* session, Socket_Reader* reader, char* request, Assembly_Output* output){
+    unsigned long sourceLength;
+    int nameStart;
+    char* source;
+
+    memset(output, 0, sizeof(Assembly_Output));
+
+    if (strncmp(request, REQUEST_FILE " ", strlen(REQUEST_FILE) + 1) == 0){
+        assembleFileInSession(session, request + strlen(REQUEST_FILE) + 1, NULL, NULL, output);
+        return 1;
+    }
+
+    if (sscanf(request, REQUEST_SOURCE " %lu %n", &sourceLength, &nameStart) == 1 && request[nameStart] != '\0'){
+        if (sourceLength > MAX_SOURCE_LENGTH){
+            setRequestError(output, "Error: the source sent to the assembler server is too long.\n");
+            return 2;
+        }
+        source = malloc(sourceLength + 1);
+        if (source == NULL){
+            setRequestError(output, "Error: not enough memory for the source sent to the assembler server.\n");
+            return 2;
+        }
+        if (!readSocketBytes(reader, source, sourceLength)){
+            free(source);
+            return 0;
+        }
+        assembleSourceInSession(session, request + nameStart, source, sourceLength, NULL, NULL, output);
+        free(source);
+        return 1;
+    }
+
+    if (strcmp(request, REQUEST_SHUTDOWN) == 0){
+        output->success = 1;
+        shuttingDown = 1;
+        shutdown(serverSocket, SHUT_RDWR); /*wakes up the accept loop*/
+        return 1;
+    }
+
+    setRequestError(output, "Error: unknown request to the assembler server.\n");
+    return 1;
+}
+
+
+/*Thread of a single connection. Handles requests until the client closes the connection.*/
+static void* handleConnection(void* connectionPointer){
+    int connection = *(int*)connectionPointer;
+    Socket_Reader* reader = malloc(sizeof(Socket_Reader));
+    char request[MAX_REQUEST_LINE_LENGTH];
+    Assembly_Output output;
+    Assembler_Session* session = takeSession();
+    int keepGoing = 1;
+    int handled;
+
+    free(connectionPointer);
+    initSocketReader(reader, connection);
+
+    while (keepGoing && readSocketLine(reader, request, sizeof(request)) >= 0){
+        handled = handleRequest(session, reader, request, &output);
+        freeIncludeCache(); /*every request is a batch of its own, so the cache does not grow while the server runs*/
+        keepGoing = handled == 1;
+        if (handled != 0 && !sendOutput(connection, &output))
+            keepGoing = 0;
+        freeAssemblyOutput(&output);
+    }
+
+    returnSession(session);
+    free(reader);
+    removeOpenConnection(connection);
+    close(connection);
+    return NULL;
+}
+
+
+/*Receives the path of a unix socket and serves assemble requests on it until a shutdown request is received.
+  Returns 0 when the server stops, 1 if the socket could not be created.*/
+int runServer(char* socketPath){
+    struct sockaddr_un address;
+    pthread_t thread;
+    pthread_attr_t threadAttributes;
+    int* connection;
+    int i;
+
+    signal(SIGPIPE, SIG_IGN); /*a client that disconnects should not stop the server*/
+
+    serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    unlink(socketPath);
+
+    if (serverSocket < 0 || bind(serverSocket, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(serverSocket, SOMAXCONN) < 0){
+        fprintf(stdout, "Error: Failed to create the assembler server socket %s.\n", socketPath);
+        return 1;
+    }
+    fprintf(stdout, "Assembler server is listening on %s\n", socketPath);
+    fflush(stdout);
+
+    pthread_attr_init(&threadAttributes);
+    pthread_attr_setdetachstate(&threadAttributes, PTHREAD_CREATE_DETACHED);
+
+    while (!shuttingDown){
+        connection = malloc(sizeof(int));
+        *connection = accept(serverSocket, NULL, NULL);
+        if (*connection < 0){
+            free(connection);
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break;
+        }
+        addOpenConnection(*connection);
+        if (pthread_create(&thread, &threadAttributes, handleConnection, connection) != 0){
+            removeOpenConnection(*connection);
+            close(*connection);
+            free(connection);
+        }
+    }
+
+    pthread_attr_destroy(&threadAttributes);
+    close(serverSocket);
+    unlink(socketPath);
+    closeOpenConnections(); /*the sessions can only be freed once no thread uses them*/
+
+    pthread_mutex_lock(&sessionsLock);
+    for (i=0; i < idleSessionCount; i++)
+        freeAssemblerSession(idleSessions[i]);
+    free(idleSessions);
+    idleSessions = NULL;
+    idleSessionCount = 0;
+    pthread_mutex_unlock(&sessionsLock);
+    return 0;
+}
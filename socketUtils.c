@@ -0,0 +1,146 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "headers/constants.h"
+#include "headers/socketUtils.h"
+
+
+/*Description: this file contains utility functions for the assembler server and its client. Requests and responses
+  are made of lines, and sections of bytes that are preceded by a line with the kind and length of the section.*/
+
+
+/*Initializes a reader of the given socket.*/
+void initSocketReader(Socket_Reader* reader, int socket){
+    reader->socket = socket;
+    reader->start = 0;
+    reader->end = 0;
+}
+
+
+/*Receives more bytes into the buffer of the reader. Returns the number of bytes received, 0 if the
+  socket was closed and -1 on error.*/
+static int fillSocketReader(Socket_Reader* reader){
+    ssize_t received;
+    if (reader->start == reader->end){
+        reader->start = 0;
+        reader->end = 0;
+    }
+    do {
+        received = read(reader->socket, reader->buffer + reader->end, sizeof(reader->buffer) - reader->end);
+    } while (received < 0 && errno == EINTR);
+    if (received > 0)
+        reader->end += received;
+    return (int)received;
+}
+
+
+/*Reads a single line (without the '\n') into line. Returns the length of the line, or -1 if the socket
+  was closed or the line is longer than maxLength.*/
+int readSocketLine(Socket_Reader* reader, char* line, int maxLength){
+    int length = 0;
+    while (1){
+        while (reader->start < reader->end){
+            char c = reader->buffer[reader->start++];
+            if (c == '\n'){
+                line[length] = '\0';
+                return length;
+            }
+            if (length >= maxLength - 1)
+                return -1;
+            line[length++] = c;
+        }
+        if (fillSocketReader(reader) <= 0)
+            return -1;
+    }
+}
+
+
+/*Reads exactly length bytes into buffer. Returns 1 if successful, 0 if the socket was closed before.*/
+int readSocketBytes(Socket_Reader* reader, char* buffer, size_t length){
+    size_t copied = 0;
+    size_t available;
+    while (copied < length){
+        if (reader->start == reader->end && fillSocketReader(reader) <= 0)
+            return 0;
+        available = reader->end - reader->start;
+        if (available > length - copied)
+            available = length - copied;
+        memcpy(buffer + copied, reader->buffer + reader->start, available);
+        reader->start += available;
+        copied += available;
+    }
+    return 1;
+}
+
+
+/*Writes all length bytes of buffer to the socket. Returns 1 if successful, 0 otherwise.*/
+int writeSocketBytes(int socket, const char* buffer, size_t length){
+    ssize_t written;
+    while (length > 0){
+        written = write(socket, buffer, length);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return 0;
+        buffer += written;
+        length -= written;
+    }
+    return 1;
+}
+
+
+/*Writes a section: a line with the kind and the length of the data, followed by the data itself.*/
+int writeSocketSection(int socket, const char* kind, const char* data, size_t length){
+    char header[MAX_REQUEST_LINE_LENGTH];
+    sprintf(header, "%s %lu\n", kind, (unsigned long)length);
+    return writeSocketBytes(socket, header, strlen(header)) && writeSocketBytes(socket, data, length);
+}
+
+
+/*Reads the next section of a response into kind and a newly allocated data buffer. Returns 1 if a section was read,
+  0 if the end of the response was reached and -1 on error.*/
+int readSocketSection(Socket_Reader* reader, char* kind, char** data, size_t* length){
+    char line[MAX_REQUEST_LINE_LENGTH];
+    unsigned long sectionLength;
+
+    if (readSocketLine(reader, line, sizeof(line)) < 0)
+        return -1;
+    if (strcmp(line, RESPONSE_END) == 0)
+        return 0;
+    if (sscanf(line, "%15s %lu", kind, &sectionLength) != 2)
+        return -1;
+
+    *data = malloc(sectionLength + 1);
+    if (!readSocketBytes(reader, *data, sectionLength)){
+        free(*data);
+        return -1;
+    }
+    (*data)[sectionLength] = '\0';
+    *length = sectionLength;
+    return 1;
+}
+
+
+/*Receives the path of a unix socket and connects to it. Returns the socket, or -1 if connecting failed.*/
+int connectToSocket(char* socketPath){
+    struct sockaddr_un address;
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+        return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    if (connect(connection, (struct sockaddr*)&address, sizeof(address)) < 0){
+        close(connection);
+        return -1;
+    }
+    return connection;
+}
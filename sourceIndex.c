@@ -0,0 +1,133 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "headers/constants.h"
+#include "headers/sourceIndex.h"
+
+
+/*Description: this file contains the source index, which is how sources are read. The file is mapped into memory
+  and the offsets of all of its lines are found in a single scan with memchr, so a line of any length is handed out
+  as a view of the mapped text without being copied. The pre processor, the first pass and the error messages that
+  look for the lines of a label share the index of a file instead of opening and reading it again.*/
+
+
+/*Finds the start of every line of the text of index.*/
+static void indexLines(Source_Index* index){
+    const char* position = index->text;
+    const char* end = index->text + index->length;
+    const char* newLine;
+    int size = INITIAL_LINE_INDEX_SIZE;
+
+    index->lineStarts = malloc(size * sizeof(size_t));
+    index->lineCount = 0;
+    while (position < end){
+        if (index->lineCount + 1 >= size){
+            size *= 2;
+            index->lineStarts = realloc(index->lineStarts, size * sizeof(size_t));
+        }
+        index->lineStarts[index->lineCount++] = position - index->text;
+        newLine = memchr(position, '\n', end - position);
+        position = newLine == NULL ? end : newLine + 1;
+    }
+    index->lineStarts[index->lineCount] = index->length;
+}
+
+
+/*Reads a file that cannot be mapped (a pipe, for example) into memory. Returns 1 if successful, 0 otherwise.*/
+static int readWholeFile(Source_Index* index, int descriptor){
+    size_t size = BUFSIZ, length = 0;
+    ssize_t readLength;
+    char* text = malloc(size);
+
+    while ((readLength = read(descriptor, text + length, size - length)) > 0){
+        length += readLength;
+        if (length == size){
+            size *= 2;
+            text = realloc(text, size);
+        }
+    }
+    if (readLength < 0){
+        free(text);
+        return 0;
+    }
+    index->ownedText = text;
+    index->text = text;
+    index->length = length;
+    return 1;
+}
+
+
+/*Receives the path of a file and returns the index of its lines (must be freed with freeSourceIndex), or NULL if
+  the file cannot be opened.*/
+Source_Index* openSourceIndex(const char* path){
+    Source_Index* index;
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    int descriptor = open(path, O_RDONLY);
+
+    if (descriptor < 0)
+        return NULL;
+    if (fstat(descriptor, &status) != 0){
+        close(descriptor);
+        return NULL;
+    }
+
+    index = calloc(1, sizeof(Source_Index));
+    index->device = (unsigned long)status.st_dev;
+    index->inode = (unsigned long)status.st_ino;
+    index->text = "";
+    if (S_ISREG(status.st_mode) && status.st_size > 0)
+        mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping != MAP_FAILED){
+        index->text = mapping;
+        index->length = status.st_size;
+        index->mappedLength = status.st_size;
+    }
+    else if ((!S_ISREG(status.st_mode) || status.st_size > 0) && !readWholeFile(index, descriptor)){
+        close(descriptor);
+        free(index);
+        return NULL;
+    }
+    close(descriptor);
+
+    indexLines(index);
+    return index;
+}
+
+
+/*Receives text in memory and its length and returns the index of its lines (must be freed with freeSourceIndex).
+  The text is not copied and must stay valid as long as the index is used.*/
+Source_Index* createSourceIndex(const char* text, size_t length){
+    Source_Index* index = calloc(1, sizeof(Source_Index));
+    index->text = text;
+    index->length = length;
+    indexLines(index);
+    return index;
+}
+
+
+/*Returns the line with the given number (counted from 0) and sets length to its length, including the '\n' unless it
+  is the last line of a source that does not end with one. The line is not terminated. Returns NULL after the last line.*/
+const char* getSourceLine(Source_Index* index, int lineNumber, size_t* length){
+    if (lineNumber < 0 || lineNumber >= index->lineCount)
+        return NULL;
+    *length = index->lineStarts[lineNumber + 1] - index->lineStarts[lineNumber];
+    return index->text + index->lineStarts[lineNumber];
+}
+
+
+/*Frees an index and unmaps its file.*/
+void freeSourceIndex(Source_Index* index){
+    if (index->mappedLength > 0)
+        munmap((void*)index->text, index->mappedLength);
+    free(index->ownedText);
+    free(index->lineStarts);
+    free(index);
+}
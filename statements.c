@@ -1,203 +1,227 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-
-#include "headers/constants.h"
-#include "headers/operations.h"
-#include "headers/memory.h"
-#include "headers/errors.h"
-#include "headers/stringUtils.h"
-#include "headers/operands.h"
-
-/*Description: this file is dedicated to all operations and data types that are related to analyzing statements in the source code.*/
-
-
-typedef enum {EMPTY, COMMENT, INSTRUCTION, COMMAND, UNIDENTIFIED} Statement_type;
-typedef enum {DATA, STRING, ENTRY, EXTERN, NONE} Instruction_type; /*types of instruction statements*/
-static Instruction_type currentInstructionType; /*Holds the type of the current instruction (if there is one)*/
-
-
-/*Returns the instruction type of the current instruction statement.*/
-Instruction_type getCurrentInstructionType(){
-    return currentInstructionType;
-}
-
-
-/*Receives an instruction statement with .data tag and calls the relevant error 
-  checking functions to ensure the statement is valid. Returns 1 if valid, 0 otherwise.*/
-void checkDataInstructionSyntax(char* statement){
-    char* pointer = strstr(statement, ".data");
-    checkForStrayString(statement, ".data");
-
-    pointer += strlen(".data"); /*Increment pointer to after .data*/
-    checkForExtraCommas(statement, pointer);
-    checkForNoCommas(pointer);
-}
-
-
-/*Receives an instruction statment with .string tag and calls the relevant error
-  checking functiions to ensure the statement is valid. Returns 1 if valid, 0 otherwise.*/
-void checkStringInstructionSyntax(char* statement){
-    char* pointer = strstr(statement, ".string");
-    checkForStrayString(statement, ".string");
-
-    pointer += strlen(".string"); /*Increment pointer to after .string*/
-    checkForValidString(pointer);
-}
-
-
-/*Receives a statement and gets the instruction that should appear after the '.'. Will return this instruction
-  even if it is invalid (will be checked later in the program).*/
-char* getInstruction(char* statement){
-    char* instruction = malloc(MAX_INSTRUCTION_LENGTH + 1);
-    char* iPointer = strchr(statement, '.'); /*Pointer to start of instruction*/
-    int i = 0;
-
-    while (*iPointer && !isspace(*iPointer)){
-        /*Iterates through token that starts with '.' until whitespace char*/
-        instruction[i] = *iPointer;
-        iPointer++;
-        i++;
-    }
-    instruction[i] = '\0';
-    return instruction;
-}
-
-/*Receives char* which is supposed to be an instruction and if it is, returns its type. OtherWise returns NONE
-  meaning no valid instruction was found in the statement.*/
-Instruction_type getInstructionType(char* instruction){
-    if (strcmp(instruction, ".data") == 0)
-        return DATA;
-    if (strcmp(instruction, ".string") == 0)
-        return STRING;
-    if (strcmp(instruction, ".extern") == 0)
-        return EXTERN;
-    if (strcmp(instruction, ".entry") == 0)
-        return ENTRY;
-    return NONE;
-}
-
-
-/*This function receives a statement from the source code and checks if it is a possible command statement by looking for '.'
-  in the statement. Returns 1 if a '.' is found, 0 otherwise.*/
-int isPossibleInstructionstatement(char* statement){
-    if (strchr(statement, '.') != NULL){
-        /*Found possible instruction declaration*/
-        return 1;
-    }
-    return 0;
-}
-
-
-/*Receives a statement and a pointer to the command section of the statement. Checks the syntax of the statement 
-  and raises errors if needed.*/
-void checkTwoOperandSyntax(char* statement, char* pointer){
-    char* firstOperand;
-    char* secondOperand;
-
-    checkForExtraCommas(statement, pointer);
-    checkForNoCommas(pointer);
-    firstOperand = getSingleOperand(pointer);
-    secondOperand = getSecondOperand(pointer);
-    
-    if (firstOperand == NULL || secondOperand == NULL){
-        raiseMissingOperand();
-        return;
-    }
-
-    if (strcmp(firstOperand, secondOperand) != 0)
-        checkForExtraOperands(statement, secondOperand); /*Looks for extra operands after second operand*/
-}
-
-
-/*Receives a statement and a pointer to the command section of the statement. Checks the syntax of the statement 
-  and raises errors if needed.*/
-void checkOneOperandSyntax(char* statement, char* pointer){
-    char* operand;
-
-    checkForExtraCommas(statement, pointer);
-    operand = getSingleOperand(pointer);
-
-    if (operand == NULL){
-        raiseMissingOperand();
-        return;
-    }
-    
-    checkForExtraOperands(statement, operand); /*Looks for extra operands after first operand*/
-}
-
-
-/*Receives a statement and a pointer to the command section of the statement. Checks the syntax of the statement 
-  and raises errors if needed.*/
-void checkJumpOperandSyntax(char* statement, char* pointer){
-    char* jumpOperand;
-
-    jumpOperand = getJumpOperand(pointer);
-
-    if (jumpOperand == NULL)
-        raiseMissingOperand();
-    
-    checkForExtraOperands(statement, jumpOperand);
-
-}
-
-/*Receives a statement, a pointer to the section of the statement after the operation name, and 
-  a pointer to the current operation in the statement and does syntax checks accordingly.*/
-void checkCommandSyntax(char* statement, char* pointer, Operation* currentOperation){
-    
-    int operandNumber = currentOperation->numberOfOperands;
-    if (!isspace(*pointer)) 
-        /*Checks if there is a whitespace immediately after op name (because pointer has been incremented to after op name)*/
-        raiseNoSpaceAfterOp();
-
-    checkForStrayString(statement, currentOperation->opName); /*Finds stray string between start of statement and opName*/
-
-    if (operandNumber == 2){ 
-        /*2 operand operation checks*/
-        checkTwoOperandSyntax(statement, pointer);
-    }
-
-    if (operandNumber == 1 && isPossibleJumpOperand(statement)){
-        /*jump operand checks*/
-        checkJumpOperandSyntax(statement, pointer);
-    }
-
-    if (operandNumber == 1 && isPossibleJumpOperand(statement) == 0){
-        /*Single operand operation checks*/
-        checkOneOperandSyntax(statement, pointer);
-        
-    }
-    if (operandNumber == 0){
-        /*No operand operation checks*/
-        checkForExtraOperands(statement, currentOperation->opName);
-    }
-
-}
-
-
-/*This function receives a statement from the source code and analyzes it to determine its type. Also updates the 
-currentInstructionType variable.*/
-Statement_type getStatementType(char* statement){
-	if (statement[0] == COMMENT_ID){
-		/*Found comment statement*/
-		return COMMENT;
-    }
-	if (strlen(statement) == 1 && statement[0] == '\n'){
-		/*Found empty line*/
-		return EMPTY;
-    }
-    if (isPossibleInstructionstatement(statement)){
-        char* instruction = getInstruction(statement);
-        currentInstructionType = getInstructionType(instruction);
-        if (currentInstructionType != NONE){ /*instruction type is valid*/
-            /*Found instruction statement*/
-            return INSTRUCTION;
-        }
-    }
-    if (getOperation(statement) != NULL){
-        /*Found command statement*/
-        return COMMAND;
-    }
-	return UNIDENTIFIED;
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "headers/constants.h"
+#include "headers/operations.h"
+#include "headers/utils.h"
+#include "headers/memory.h"
+#include "headers/errors.h"
+#include "headers/stringUtils.h"
+#include "headers/operands.h"
+#include "headers/context.h"
+#include "headers/arena.h"
+#include "headers/lexer.h"
+
+/*Description: this file is dedicated to all operations and data types that are related to analyzing statements in the source code.*/
+
+
+typedef enum {EMPTY, COMMENT, INSTRUCTION, COMMAND, UNIDENTIFIED} Statement_type;
+typedef enum {DATA, STRING, ENTRY, EXTERN, NONE} Instruction_type; /*types of instruction statements*/
+
+
+/*Returns the instruction type of the current instruction statement.*/
+Instruction_type getCurrentInstructionType(){
+    return (Instruction_type)getCurrentContext()->currentInstructionType;
+}
+
+
+/*Receives the tokens of a statement and the index of a token, and returns 1 if the token starts right after the
+  token before it, without whitespace between them.*/
+static int isAdjacentToken(Token_Stream* tokens, int index){
+    Token* previous = &tokens->tokens[index - 1];
+    return tokens->tokens[index].offset == previous->offset + previous->length;
+}
+
+
+/*Checks the commas between the tokens after the keyword of the statement that was lexed last: a comma before the
+  first token that follows whitespace, two commas with no other token between them from that token on, and a comma at
+  the end of the statement. Raises an error for the first one that is found. Returns 1 if there are no invalid commas,
+  0 otherwise.*/
+static int checkForExtraCommas(){
+    Token_Stream* tokens = getStatementTokens();
+    int i = tokens->keyword + 1;
+
+    while (i < tokens->tokenCount && isAdjacentToken(tokens, i))
+        i++;
+    if (i < tokens->tokenCount && tokens->tokens[i].type == TOKEN_COMMA){
+        raiseCommaAtStart();
+        return 0;
+    }
+    for (i++; i < tokens->tokenCount; i++){
+        if (tokens->tokens[i].type == TOKEN_COMMA && tokens->tokens[i - 1].type == TOKEN_COMMA){
+            raiseConsecutiveCommas();
+            return 0;
+        }
+    }
+    if (tokens->tokens[tokens->tokenCount - 1].type == TOKEN_COMMA){
+        raiseCommaAtEnd();
+        return 0;
+    }
+    /*No invalid commas*/
+    return 1;
+}
+
+
+/*Checks that the tokens after the keyword of the statement that was lexed last that are separated by whitespace have
+  a comma between them. Returns 1 if they do, 0 otherwise.*/
+static int checkForNoCommas(){
+    Token_Stream* tokens = getStatementTokens();
+    int i;
+
+    for (i = tokens->keyword + 2; i < tokens->tokenCount; i++){
+        if (!isAdjacentToken(tokens, i) && tokens->tokens[i].type != TOKEN_COMMA && tokens->tokens[i - 1].type != TOKEN_COMMA){
+            raiseNoCommasBetween();
+            return 0;
+        }
+    }
+    /*Commas between each token*/
+    return 1;
+}
+
+
+/*Receives an offset in the statement that was lexed last, such as the end of its last operand, and raises an error
+  if there are tokens after it.*/
+static void checkForExtraOperands(int end){
+    Token_Stream* tokens = getStatementTokens();
+    Token* last = &tokens->tokens[tokens->tokenCount - 1];
+
+    if (last->offset >= end)
+        /*Found a token where there shouldn't be one*/
+        raiseTooManyOperands();
+}
+
+
+/*Receives an instruction statement with .data tag and calls the relevant error 
+  checking functions to ensure the statement is valid. Returns 1 if valid, 0 otherwise.*/
+void checkDataInstructionSyntax(char* statement){
+    char* pointer = getKeyword(statement);
+    checkForStrayString(statement, pointer);
+
+    checkForExtraCommas();
+    checkForNoCommas();
+}
+
+
+/*Receives an instruction statment with .string tag and calls the relevant error
+  checking functiions to ensure the statement is valid. Returns 1 if valid, 0 otherwise.*/
+void checkStringInstructionSyntax(char* statement){
+    char* pointer = getKeyword(statement);
+    checkForStrayString(statement, pointer);
+
+    pointer += strlen(".string"); /*Increment pointer to after .string*/
+    checkForValidString(pointer);
+}
+
+
+/*Checks the syntax of the operands of the two operand command that was lexed last and raises errors if needed.*/
+void checkTwoOperandSyntax(){
+    Text_Span firstOperand;
+    Text_Span secondOperand;
+
+    checkForExtraCommas();
+    checkForNoCommas();
+    firstOperand = getSingleOperand();
+    secondOperand = getSecondOperand();
+    
+    if (firstOperand.length == 0 || secondOperand.length == 0){
+        raiseMissingOperand();
+        return;
+    }
+
+    checkForExtraOperands(secondOperand.offset + secondOperand.length); /*Looks for extra operands after second operand*/
+}
+
+
+/*Checks the syntax of the operand of the one operand command that was lexed last and raises errors if needed.*/
+void checkOneOperandSyntax(){
+    Text_Span operand;
+
+    checkForExtraCommas();
+    operand = getSingleOperand();
+
+    if (operand.length == 0){
+        raiseMissingOperand();
+        return;
+    }
+    
+    checkForExtraOperands(operand.offset + operand.length); /*Looks for extra operands after first operand*/
+}
+
+
+/*Checks the syntax of the jump operand of the command that was lexed last and raises errors if needed.*/
+void checkJumpOperandSyntax(){
+    Text_Span jumpOperand;
+
+    jumpOperand = getJumpOperand();
+
+    if (jumpOperand.length == 0){
+        raiseMissingOperand();
+        return;
+    }
+    
+    checkForExtraOperands(jumpOperand.offset + jumpOperand.length);
+
+}
+
+/*Receives a statement, a pointer to the section of the statement after the operation name, and 
+  a pointer to the current operation in the statement and does syntax checks accordingly.*/
+void checkCommandSyntax(char* statement, char* pointer, Operation* currentOperation){
+    char* opName = getKeyword(statement); /*the operation name in the statement*/
+    int operandNumber = currentOperation->numberOfOperands;
+    if (!isspace(*pointer)) 
+        /*Checks if there is a whitespace immediately after op name (because pointer has been incremented to after op name)*/
+        raiseNoSpaceAfterOp();
+
+    checkForStrayString(statement, opName); /*Finds stray string between start of statement and opName*/
+
+    if (operandNumber == 2){ 
+        /*2 operand operation checks*/
+        checkTwoOperandSyntax();
+    }
+
+    if (operandNumber == 1 && isPossibleJumpOperand()){
+        /*jump operand checks*/
+        checkJumpOperandSyntax();
+    }
+
+    if (operandNumber == 1 && isPossibleJumpOperand() == 0){
+        /*Single operand operation checks*/
+        checkOneOperandSyntax();
+        
+    }
+    if (operandNumber == 0){
+        /*No operand operation checks*/
+        checkForExtraOperands(getKeywordToken()->offset + getKeywordToken()->length);
+    }
+
+}
+
+
+/*This function receives a statement from the source code, lexes it (see lexer.c) and determines its type by its
+keyword, its first directive or operation name. Also updates the currentInstructionType variable.*/
+Statement_type getStatementType(char* statement){
+    Token* keyword;
+
+	if (statement[0] == COMMENT_ID){
+		/*Found comment statement*/
+		return COMMENT;
+    }
+	if (strlen(statement) == 1 && statement[0] == '\n'){
+		/*Found empty line*/
+		return EMPTY;
+    }
+    lexStatement(statement);
+    keyword = getKeywordToken();
+    getCurrentContext()->currentInstructionType = NONE;
+    if (keyword == NULL)
+	    return UNIDENTIFIED;
+    if (keyword->type == TOKEN_DIRECTIVE){
+        /*Found instruction statement*/
+        getCurrentContext()->currentInstructionType = keyword->value;
+        return INSTRUCTION;
+    }
+    /*Found command statement*/
+    return COMMAND;
 }
\ No newline at end of file
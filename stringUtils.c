@@ -1,201 +1,167 @@
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-#include <ctype.h>
-
-#include "headers/constants.h"
-#include "headers/errors.h"
-#include "headers/operations.h"
-
-
-/*Description: this file contains utility functions that handle strings.*/
-
-
-/*This function receives a string and returns an array of all the tokens in the string split by white space.*/
-char** splitLineByWhitespace(char* str){
-    int i = 0; /*Iterates through str*/
-    int j = 0; /*used to add tokens to splitString*/
-    int k = 0; /*Used to add chars to current pointer*/
-
-    char** splitString = malloc(sizeof(char*));
-    splitString[0] = NULL;
-
-    while (i < strlen(str)) {
-        /*Skip whitespace characters*/
-        while (str[i] == ' ' || str[i] == '\t' || str[i] == '\n') {
-            i++;
-        }
-
-        splitString[j] = malloc(MAX_STATEMENT_LENGTH * sizeof(char));
-
-        k = 0;
-        while (str[i] != ' ' && str[i] != '\t' && str[i] != '\n' && str[i] != '\0') {
-            /*Current characters are not whitespace*/
-            splitString[j][k] = str[i];
-            k++;
-            i++;
-        }
-        splitString[j][k] = '\0'; /*Terminates current pointer*/
-        j++;
-        splitString = realloc(splitString, (j + 1) * sizeof(char*));
-        splitString[j] = NULL;
-    }
-    splitString[j-1] = NULL; /*Ensures that array is null terminated at the correct spot*/
-    return splitString;
-}
-
-
-/*This function receives a string and removes all leading and trailind whitespace (except for \n at the end)*/
-void trimWhitespace(char* str){
-    /*Remove leading whitespace*/
-    int count = 0;
-    int i = 0;
-    while (str[count] == ' ' || str[count] == '\t'){
-        count++;
-    }
-
-    for (i=0; (i + count) < strlen(str); i++){
-        str[i] = str[i + count];
-    }
-    str[i] = '\0';
-
-
-    /*Remove trailing whitespace*/
-    i = strlen(str) - 1;
-
-    while (i >= 0){
-        if (str[i] == ' ' || str[i] == '\t' || str[i] == '\n')
-            i--;
-        else break;
-    }
-
-    str[i+1] = '\n'; /*Adds newline back because it is removed along with other whitespace*/
-    str[i+2] = '\0';
-}
-
-
-/*Receives a statement and a pointer. Gets pointer to place in statement and checks 
-  if there are commas between the end of the token pointed to by pointer and the beginning of the next token and checks
-  if there are consecutive commas with no chars between them within the next token. 
-  Also check if there are commas at the end of the statement. Returns 1 if there are no invalid commas, 0 otherwise.*/
-int checkForExtraCommas(char* statement, char* pointer){
-    int lookForStartComma = 0; /*Acts as bool that indicates if to look for comma before next pointer*/
-    int withinNextToken = 0; /*Acts as bool that indicates if iterating within the pointer after the given pointer*/
-    int lookForConsecutiveComma = 0; /*Acts as bool that indicated if looking for two consecutive commas*/
-    while (*pointer){
-        if (isspace(*pointer) && !withinNextToken){
-            /*start looking for comma between pointer and next token*/
-            lookForStartComma = 1;
-        }
-        if (lookForStartComma && *pointer == ','){
-            raiseCommaAtStart(pointer);
-            return 0;
-        }
-        if (lookForStartComma && !isspace(*pointer)){
-            lookForStartComma = 0;
-            withinNextToken = 1;
-        }
-        if (withinNextToken && lookForConsecutiveComma && *pointer == ','){
-            raiseConsecutiveCommas(pointer);
-            return 0;
-        }
-        if (withinNextToken && *pointer == ','){
-            lookForConsecutiveComma = 1;
-        }
-        if (withinNextToken && lookForConsecutiveComma && *pointer != ',' && !isspace(*pointer)){
-            lookForConsecutiveComma = 0;
-        }
-        pointer++;
-    }
-    if (statement[strlen(statement)-2] == ','){ /*Checks for comma at end of statement. -2 because last char is '\n'*/
-        raiseCommaAtEnd(statement);
-        return 0;
-    }
-    /*No invalid commas*/
-    return 1;
-}
-
-/*Receives string and checks if there are two consecutive tokens without a comma between them. Returns 1 if 
-  there are commas between each token, 0 otherwise.*/
-int checkForNoCommas(char* pointer){
-    int lookForComma = 0;
-    while (*pointer){
-        if (lookForComma && *pointer && !isspace(*pointer) && *pointer != ','){
-            raiseNoCommasBetween(pointer);
-            return 0;
-        }
-        if (lookForComma && *pointer == ',')
-            lookForComma = 0;
-        if (!isspace(*pointer) && *pointer != ',' && isspace(*(pointer+1)))
-            /*only looks for comma if the current char is not a space and not a comma and the next char is a space*/
-            lookForComma = 1;
-        pointer++;
-    }
-    /*Commas between each token*/
-    return 1;
-}
-
-
-/*Receives a pointer to a char in a larger string and iterates backwards in string until reaching start of string or label
-declaration. If any stray token is found, raises error and returns 0. Returns 1 otherwise.*/
-int checkForStrayString(char* statement, char* token){
-    char* statementCopy = malloc(strlen(statement) + 1);
-    char* pointer = strstr(statement, token);
-
-    statementCopy = strcpy(statementCopy, statement);
-    while (*pointer){
-        pointer--;
-
-        if (!isspace(*pointer) && *pointer != ':' && (strcmp(pointer, "") != 0)){
-            /*found character that is not empy character or ':'.*/
-            raiseStrayTokenError();
-            return 0;
-        }
-        if (*pointer == ':')
-            /*Reached label declaration*/
-            break;
-    }
-    return 1;
-}
-
-
-/*Used to check if the string given in a .string statement is valid.*/
-void checkForValidString(char* string){
-    trimWhitespace(string);
-    if (string[0] != '"' || string[strlen(string) - 2] != '"')
-        raiseNoQuotesError();
-    
-}
-
-
-/*Receives statement and str and checks if there are any stray tokens (separated by whitespace) after str.
-  Raises appropriate error if there are.*/
-void checkForExtraOperands(char* statement, char* str){
-    char* pointer = strstr(statement, str) + strlen(str); /*Increment to after str*/
-    
-    while (*pointer){
-        
-        if (!isspace(*pointer)){
-            /*Found non whitespace character where there shouldn't be one*/
-            raiseTooManyOperands();
-            break;
-        }
-        pointer++;
-    }
-}
-
-
-/*Receives a string and checks if there are too many parentheses in it.*/
-void checkTooManyParentheses(char* str){
-    char* pointer = str;
-    int parenthesesCount = 0;
-    while (*pointer){
-        if (*pointer == '(' || *pointer == ')')
-            parenthesesCount++;
-        if (parenthesesCount > 2){
-            raiseTooManyParentheses();
-            break;
-    }
-    pointer++;
-    }
-}
\ No newline at end of file
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+
+#include "headers/constants.h"
+#include "headers/errors.h"
+#include "headers/operations.h"
+#include "headers/stringUtils.h"
+
+
+/*Description: this file contains utility functions that handle strings.*/
+
+
+/*Receives a buffer of the given size (or NULL and 0), a line that is not terminated and its length, and copies the line
+  into the buffer, enlarging it if needed. The buffer has room for the '\n' and '\0' that trimWhitespace may add.
+  Returns the buffer (must be freed).*/
+char* copyLine(char* buffer, size_t* size, const char* line, size_t length){
+    if (length + 2 > *size){
+        *size = length + 2 > 2 * *size ? length + 2 : 2 * *size;
+        buffer = realloc(buffer, *size);
+    }
+    memcpy(buffer, line, length);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+
+/*Returns 1 if c is whitespace that trimWhitespace removes from the start of a line, 0 otherwise.*/
+static int isLeadingWhitespace(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+/*Returns 1 if c is whitespace that trimWhitespace removes from the end of a line, 0 otherwise.*/
+static int isTrailingWhitespace(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+
+/*This function receives a string and removes all leading and trailind whitespace (except for \n at the end).
+  '\r' is treated as whitespace so that source files with windows line endings are read the same on every system.*/
+void trimWhitespace(char* str){
+    size_t start = 0;
+    size_t length;
+
+    while (isLeadingWhitespace(str[start]))
+        start++;
+    length = strlen(str + start);
+    while (length > 0 && isTrailingWhitespace(str[start + length - 1]))
+        length--;
+
+    memmove(str, str + start, length);
+    str[length] = '\n'; /*Adds newline back because it is removed along with other whitespace*/
+    str[length + 1] = '\0';
+}
+
+
+/*Receives a string and returns a pointer to its first char that is not whitespace trimWhitespace removes from the
+  start of a line, without changing the string.*/
+char* skipLeadingWhitespace(char* str){
+    while (isLeadingWhitespace(*str))
+        str++;
+    return str;
+}
+
+
+/*Receives a line that is not terminated and its length, and returns the number of chars that copyTrimmedLine removes
+  from its start (its indentation).*/
+size_t countLeadingWhitespace(const char* line, size_t length){
+    size_t count = 0;
+    while (count < length && isLeadingWhitespace(line[count]))
+        count++;
+    return count;
+}
+
+
+/*Receives a buffer of the given size (or NULL and 0), a line that is not terminated and its length, and copies the
+  line into the buffer without its leading and trailing whitespace, followed by '\n' and '\0', which is the same as
+  copyLine followed by trimWhitespace without moving the line in the buffer. Sets length to the length of the copy
+  (with the '\n'). Returns the buffer (must be freed).*/
+char* copyTrimmedLine(char* buffer, size_t* size, const char* line, size_t* length){
+    const char* end = memchr(line, '\0', *length); /*the line ends at a '\0', as it does for trimWhitespace*/
+    size_t trimmedLength = end != NULL ? (size_t)(end - line) : *length;
+
+    while (trimmedLength > 0 && isLeadingWhitespace(*line)){
+        line++;
+        trimmedLength--;
+    }
+    while (trimmedLength > 0 && isTrailingWhitespace(line[trimmedLength - 1]))
+        trimmedLength--;
+
+    buffer = copyLine(buffer, size, line, trimmedLength);
+    buffer[trimmedLength] = '\n';
+    buffer[trimmedLength + 1] = '\0';
+    *length = trimmedLength + 1;
+    return buffer;
+}
+
+
+/*Returns 1 if c separates the words of splitLineSpans, 0 otherwise.*/
+static int isWordSeparator(char c){
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+
+/*Receives a line and an array of maxSpans spans, and splits the line into the words that are separated by whitespace.
+  The first maxSpans words are written into spans as the offset and length of each word in the line, so nothing is
+  copied or allocated. Returns the number of words in the line, which may be more than maxSpans.*/
+int splitLineSpans(const char* line, Text_Span* spans, int maxSpans){
+    const char* pointer = line;
+    const char* start;
+    int wordCount = 0;
+
+    while (*pointer){
+        while (isWordSeparator(*pointer))
+            pointer++;
+        if (*pointer == '\0')
+            break;
+        start = pointer;
+        while (*pointer && !isWordSeparator(*pointer))
+            pointer++;
+        if (wordCount < maxSpans){
+            spans[wordCount].offset = start - line;
+            spans[wordCount].length = pointer - start;
+        }
+        wordCount++;
+    }
+    return wordCount;
+}
+
+
+/*Receives a line, a word of the line (see splitLineSpans) and a string and returns 1 if the word is the string, 0
+  otherwise.*/
+int isSpanText(const char* line, Text_Span span, const char* text){
+    return (int)strlen(text) == span.length && strncmp(line + span.offset, text, span.length) == 0;
+}
+
+
+/*Receives a statement and a pointer to a token in it and iterates backwards in the statement until reaching start of
+statement or label declaration. If any stray token is found, raises error and returns 0. Returns 1 otherwise.*/
+int checkForStrayString(char* statement, char* token){
+    char* pointer = token;
+
+    while (pointer > statement){
+        pointer--;
+
+        if (!isspace(*pointer) && *pointer != ':'){
+            /*found character that is not empy character or ':'.*/
+            raiseStrayTokenError();
+            return 0;
+        }
+        if (*pointer == ':')
+            /*Reached label declaration*/
+            break;
+    }
+    return 1;
+}
+
+
+/*Used to check if the string given in a .string statement is valid.*/
+void checkForValidString(char* string){
+    trimWhitespace(string);
+    if (string[0] != '"' || string[strlen(string) - 2] != '"')
+        raiseNoQuotesError();
+    
+}
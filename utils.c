@@ -1,214 +1,160 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-
-#include "headers/constants.h"
-
-
-/*Description: this file contains utility functions that are used throughout the assembler. Mostly contains 
-  functions that convert data to binary and encode data to binary.*/
-
-
-char* convertToBinary(unsigned int operand, int length);
-void fillBits1to0(char* word,  int encodingType);
-
-
-/*Receives a word that is supposed to be written to memory and fills bits 13-10 of the word accordingly.
-  isJump is used as a bool to indicate whether the word refers to a jump operand or not.*/
-void fillBits13to10(char* word, int isJump, int sourceType, int destType){
-	int i;
-	if (!isJump){
-		/*Fills bits 13-10 with zeros because they are only relevant to jump operation*/
-		for (i = 0; i < 4; i++){
-			word[i] = BIN_ZERO;
-		}
-	}
-	else{
-		/*fill bits 13-10 for jump operation*/
-		char* sourceBin = convertToBinary(sourceType, 2);
-		char* destBin = convertToBinary(destType, 2);
-
-		/*source operand*/
-		word[0] = sourceBin[0];
-		word[1] = sourceBin[1];
-		/*destination operand*/
-		word[2] = destBin[0];
-		word[3] = destBin[1];
-
-		free(sourceBin);
-		free(destBin);
-	}
-	
-}
-
-
-/*Receives a word that is supposed to be written to memory and fills bits 9-6 (opcode) of the word accordingly.*/
-void fillBits9to6(char* word, int opCode){
-	char* opCodeBin = convertToBinary(opCode, 4); /*4 because this is used to fill 4 bits*/
-
-	/*Copies the encoding of the opcode to bits 9-6 of the word*/
-	word[4] = opCodeBin[0];
-	word[5] = opCodeBin[1];
-	word[6] = opCodeBin[2];
-	word[7] = opCodeBin[3];
-
-	free(opCodeBin);
-}
-
-
-/*Receives a word that is supposed to be written to memory and fills bits 5-4 (source operand type)
-  of the word accordingly. hasSource acts as a bool to indicate if the operation of the word has a source operand.*/
-void fillBits5to4(char* word, int assignmentType, int hasSource){
-
-	if (!hasSource){
-		/*there is no source operand so fill with zeros*/
-		word[8] = BIN_ZERO;
-		word[9] =  BIN_ZERO;
-	}
-	else{
-		char* sourceBin = convertToBinary(assignmentType, 2); /*2 because this is used to fill 2 bits*/
-		word[8] = sourceBin[0];
-		word[9] =  sourceBin[1];
-		free(sourceBin);
-	}
-}
-
-/*Receives a word that is supposed to be written to memory and fills bits 3-2 (destination operand type)
-  of the word accordingly. hasDest acts as a bool to indicate if the operation of the word has a destination operand.*/
-void fillBits3to2(char* word, int assignmentType, int hasDest){
-	if (!hasDest){
-		/*there is no destination operand so fill with zeros*/
-		word[10] = BIN_ZERO;
-		word[11] = BIN_ZERO;
-	}
-	else{
-		char* destBin = convertToBinary(assignmentType, 2); /*2 because this is used to fill 2 bits*/
-		word[10] = destBin[0];
-		word[11] = destBin[1];
-		free(destBin);
-	}
-}
-
-
-/*Receives a word that is supposed to be written to memory and fills bits 1-0 (encoding type)
-  with the given encoding type.*/
-void fillBits1to0(char* word,  int encodingType){
-	/*TODO: wait for answer in forum to know how to handle labels in the word*/
-
-	if (encodingType == 0){
-		/*Absolute encoding*/
-		word[12] = BIN_ZERO;
-		word[13] = BIN_ZERO;
-	}
-
-	if (encodingType == 1){
-		/*External encoding*/
-		word[12] = BIN_ZERO;
-		word[13] = BIN_ONE;
-	}
-
-	if (encodingType == 2){
-		/*Relocatable encoding*/
-		word[12] = BIN_ONE;
-		word[13] = BIN_ZERO;
-	}
-}
-
-
-/*Receives a register operand and encodes it accordingly. isSource acts as bool 
-  to indicate if the register is a source operand or not. isOnlyOperand acts as bool
-  to indicate if the register is alone on the word or shares it with another register.*/
-void fillRegisterWord(char* word, int registerNum, int isSource, int isOnlyOperand, int ARE){
-	int i;
-	char* registerBin = convertToBinary(registerNum, 6); /*6 is the length of bits 13-8*/
-	if (isSource){
-		/*fill bits 13 to 8*/
-		for (i=0; i < 6; i++){
-			word[i] = registerBin[i];
-		}
-		if (isOnlyOperand){
-			/*only fiils with zeros if this register is the only operand in this word*/
-			for (i=6; i < 12; i++){
-				word[i] = BIN_ZERO;
-			}
-		}
-	}
-
-	else{
-		if (isOnlyOperand){
-			/*only fiils with zeros if this register is the only operand in this word*/
-			for (i=0; i < 6; i++){
-				word[i] = BIN_ZERO;
-			}
-		}
-		/*fill rest with zeros*/
-		for (i=6; i < 12; i++){
-			word[i] = registerBin[i-strlen(registerBin)];
-		}
-	}
-	fillBits1to0(word, ARE);
-	free(registerBin);	
-}
-
-
-/*Receives a number and encodes it accordingly.*/
-void fillImmediateNumberWord(char* word, int number, int ARE){
-	int i;
-	char* numberBin = convertToBinary(number, 12); /*fills first 12 bits of word with number*/
-
-	for (i=0; i < 12; i++){
-		word[i] = numberBin[i];
-	}
-	fillBits1to0(word, ARE);
-	free(numberBin);
-}
-
-
-/*Receives label's address and its encoding type and encodes it accordingly*/
-void encodeLabelAddress(char* word, int labelAddress, int encodingType){
-	int i;
-	char* addressBin = convertToBinary(labelAddress, 12);
-	for (i=0; i < 12; i++){
-		word[i] = addressBin[i];
-	}
-	fillBits1to0(word, encodingType);
-	free(addressBin);
-}
-
-
-/*This function receives an operand that can be an int or a char and the desired length of the binary output. It then
-  converts the given operand into its binary representation (using the unique binary language), returning it as a string.*/
-char* convertToBinary(unsigned int operand, int length){
-	int c;
-	int i = 0;
-	char* bin = malloc(sizeof(char) * length + 1);
-
-	while (i < length){
-		c = operand % 2;
-		if (c == 0)
-			bin[i] = BIN_ZERO;
-		else
-			bin[i] = BIN_ONE;
-
-		operand = operand / 2;
-		i++;
-	}
-	bin[i] = '\0';
-	bin = strrev(bin); /*Reverse bin so binary goes from right to left*/
-    return bin;
-}
-
-
-/*Receives filename and deletes all output files that were created during the assembly process.*/
-void deleteOutputFiles(char* filename){
-	char* filepath = malloc((strlen(filename) * sizeof(char)) + strlen(EXTERNALS_FILETYPE));
-	sprintf(filepath, "%s%s", filename, OBJECT_FILETYPE);
-	remove(filepath); /*remove.ob file*/
-	sprintf(filepath, "%s%s", filename, EXTERNALS_FILETYPE);
-	remove(filepath); /*remove.ext file*/
-	sprintf(filepath, "%s%s",filename, ENTRIES_FILETYPE);
-	remove(filepath); /*remove.ent file*/
-
-	free(filepath);
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "headers/constants.h"
+#include "headers/utils.h"
+
+
+/*Description: this file contains utility functions that are used throughout the assembler. Mostly contains 
+  functions that convert data to binary and encode data to binary.*/
+
+
+static void setWordBits(Machine_Word* word, int lowBit, int length, unsigned int value);
+
+
+/*Receives a word that is supposed to be written to memory and fills bits 13-10 of the word accordingly.
+  isJump is used as a bool to indicate whether the word refers to a jump operand or not.*/
+void fillBits13to10(Machine_Word* word, int isJump, int sourceType, int destType){
+	/*bits 13-10 are only relevant to jump operation, so they are zeros otherwise*/
+	setWordBits(word, 12, 2, isJump ? sourceType : 0); /*source operand*/
+	setWordBits(word, 10, 2, isJump ? destType : 0); /*destination operand*/
+}
+
+
+/*Receives a word that is supposed to be written to memory and fills bits 9-6 (opcode) of the word accordingly.*/
+void fillBits9to6(Machine_Word* word, int opCode){
+	setWordBits(word, 6, 4, opCode);
+}
+
+
+/*Receives a word that is supposed to be written to memory and fills bits 5-4 (source operand type)
+  of the word accordingly. hasSource acts as a bool to indicate if the operation of the word has a source operand.*/
+void fillBits5to4(Machine_Word* word, int assignmentType, int hasSource){
+	/*if there is no source operand fill with zeros*/
+	setWordBits(word, 4, 2, hasSource ? assignmentType : 0);
+}
+
+/*Receives a word that is supposed to be written to memory and fills bits 3-2 (destination operand type)
+  of the word accordingly. hasDest acts as a bool to indicate if the operation of the word has a destination operand.*/
+void fillBits3to2(Machine_Word* word, int assignmentType, int hasDest){
+	/*if there is no destination operand fill with zeros*/
+	setWordBits(word, 2, 2, hasDest ? assignmentType : 0);
+}
+
+
+/*Receives a word that is supposed to be written to memory and fills bits 1-0 (encoding type)
+  with the given encoding type: 00 for absolute, 01 for external and 10 for relocatable encoding.*/
+void fillBits1to0(Machine_Word* word,  int encodingType){
+	setWordBits(word, 0, 2, encodingType);
+}
+
+
+/*Receives a register operand and encodes it accordingly. isSource acts as bool 
+  to indicate if the register is a source operand or not. isOnlyOperand acts as bool
+  to indicate if the register is alone on the word or shares it with another register.*/
+void fillRegisterWord(Machine_Word* word, int registerNum, int isSource, int isOnlyOperand, int ARE){
+	if (isSource){
+		setWordBits(word, 8, 6, registerNum); /*fill bits 13 to 8*/
+		if (isOnlyOperand)
+			/*only fills with zeros if this register is the only operand in this word*/
+			setWordBits(word, 2, 6, 0);
+	}
+
+	else{
+		if (isOnlyOperand)
+			/*only fills with zeros if this register is the only operand in this word*/
+			setWordBits(word, 8, 6, 0);
+		setWordBits(word, 2, 6, registerNum); /*fill bits 7 to 2*/
+	}
+	fillBits1to0(word, ARE);
+}
+
+
+/*Receives a number and encodes it accordingly.*/
+void fillImmediateNumberWord(Machine_Word* word, int number, int ARE){
+	setWordBits(word, 2, 12, number); /*fills first 12 bits of word with number*/
+	fillBits1to0(word, ARE);
+}
+
+
+/*Receives label's address, its encoding type and the number of bits of the address (ADDRESS_BITS, or
+  LARGE_ADDRESS_BITS in large memory mode) and encodes it accordingly*/
+void encodeLabelAddress(Machine_Word* word, int labelAddress, int encodingType, int addressBits){
+	setWordBits(word, 2, addressBits, labelAddress);
+	fillBits1to0(word, encodingType);
+}
+
+
+/*Receives a number (or a char) and returns it as a word of memory, keeping its lowest wordSize bits (negative
+  numbers in two's complement).*/
+Machine_Word convertToWord(int number){
+	return (Machine_Word)((unsigned int)number & WORD_MASK);
+}
+
+
+/*Writes length bits of value, starting at bit lowBit, into word. The bits of value above length are dropped, so
+  negative numbers are written in two's complement.*/
+static void setWordBits(Machine_Word* word, int lowBit, int length, unsigned int value){
+	unsigned int mask = ((1u << length) - 1) << lowBit;
+	*word = (Machine_Word)((*word & ~mask) | ((value << lowBit) & mask));
+}
+
+
+/*The binary representation of every 7 bit number (half a word), so that a word is rendered with two lookups.*/
+#define HALF_WORD_BIT(number, bit) (((number) >> (bit)) & 1 ? BIN_ONE : BIN_ZERO)
+#define HALF_WORD_TEXT(n) {HALF_WORD_BIT(n, 6), HALF_WORD_BIT(n, 5), HALF_WORD_BIT(n, 4), HALF_WORD_BIT(n, 3), \
+	HALF_WORD_BIT(n, 2), HALF_WORD_BIT(n, 1), HALF_WORD_BIT(n, 0)}
+#define HALF_WORD_TEXT_2(n) HALF_WORD_TEXT(n), HALF_WORD_TEXT((n) + 1)
+#define HALF_WORD_TEXT_4(n) HALF_WORD_TEXT_2(n), HALF_WORD_TEXT_2((n) + 2)
+#define HALF_WORD_TEXT_8(n) HALF_WORD_TEXT_4(n), HALF_WORD_TEXT_4((n) + 4)
+#define HALF_WORD_TEXT_16(n) HALF_WORD_TEXT_8(n), HALF_WORD_TEXT_8((n) + 8)
+#define HALF_WORD_TEXT_32(n) HALF_WORD_TEXT_16(n), HALF_WORD_TEXT_16((n) + 16)
+#define HALF_WORD_TEXT_64(n) HALF_WORD_TEXT_32(n), HALF_WORD_TEXT_32((n) + 32)
+
+static const char halfWordText[1 << HALF_WORD_BITS][HALF_WORD_BITS] = {HALF_WORD_TEXT_64(0), HALF_WORD_TEXT_64(64)};
+
+
+/*Receives a word of memory and its width in bits (wordSize, or LARGE_WORD_SIZE in large memory mode, a multiple of
+  HALF_WORD_BITS) and writes its binary representation (using the unique binary language, from the highest bit to
+  bit 0) into text. Writes exactly width chars, without a terminator, and returns the end of the written chars.*/
+char* renderWord(Machine_Word word, int width, char* text){
+	int bit;
+	for (bit = width - HALF_WORD_BITS; bit >= 0; bit -= HALF_WORD_BITS){
+		memcpy(text, halfWordText[(word >> bit) & HALF_WORD_MASK], HALF_WORD_BITS);
+		text += HALF_WORD_BITS;
+	}
+	return text;
+}
+
+
+/*Receives a non negative number and writes it in decimal into text, without a terminator. Returns the end of the
+  written chars.*/
+char* renderDecimal(int number, char* text){
+	char digits[sizeof(int) * 3];
+	int length = 0;
+	do {
+		digits[length++] = '0' + number % 10;
+		number /= 10;
+	} while (number > 0);
+	while (length > 0)
+		*text++ = digits[--length];
+	return text;
+}
+
+
+/*Receives filename and deletes all output files that were created during the assembly process.*/
+void deleteOutputFiles(char* filename){
+	char* filepath = malloc((strlen(filename) * sizeof(char)) + strlen(EXTERNALS_FILETYPE) + 1);
+	sprintf(filepath, "%s%s", filename, OBJECT_FILETYPE);
+	remove(filepath); /*remove.ob file*/
+	sprintf(filepath, "%s%s", filename, EXTERNALS_FILETYPE);
+	remove(filepath); /*remove.ext file*/
+	sprintf(filepath, "%s%s",filename, ENTRIES_FILETYPE);
+	remove(filepath); /*remove.ent file*/
+	sprintf(filepath, "%s%s",filename, BINARY_OBJECT_FILETYPE);
+	remove(filepath); /*remove.obj file*/
+
+	free(filepath);
 }
\ No newline at end of file
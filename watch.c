@@ -0,0 +1,188 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "headers/constants.h"
+#include "headers/includes.h"
+#include "headers/watch.h"
+
+
+/*Description: this file contains the watch mode of the assembler (main --watch). The directory of every given file
+  is watched with inotify, and whenever a source file is written or replaced (editors often save by renaming a new
+  file over the old one) only that file is assembled again and its messages are printed. The files a source includes
+  are watched as well, for the files that include them, and are registered again after every run since the includes
+  may have changed. The process keeps running until it is stopped, so the tables of the assembler stay allocated
+  between runs.*/
+
+
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+#define NAME_MAX_LENGTH 255
+#define EVENT_BUFFER_SIZE (64 * (sizeof(struct inotify_event) + NAME_MAX_LENGTH + 1))
+
+
+/*A file that is read when one of the given files is assembled. When it changes, that file is assembled again.*/
+typedef struct Watched_File{
+    int watchDescriptor; /*watch of the directory of the file*/
+    char* name; /*name of the file in its directory, e.g. "prog.as"*/
+    int fileIndex; /*index of the given file that should be assembled when this file changes*/
+    int isInclude; /*bool, the file is included by the given file rather than being its source*/
+} Watched_File;
+
+
+typedef struct Watch_List{
+    Watched_File* files;
+    int fileCount;
+    int filesSize;
+} Watch_List;
+
+
+/*Receives the inotify instance, the list and the path of a file, and starts watching the file for changes of the
+  given file of the command line, which includes it if isInclude is set. Returns 0 if the directory of the file cannot
+  be watched.*/
+static int addWatchedFile(int inotify, Watch_List* list, const char* path, int fileIndex, int isInclude){
+    const char* slash = strrchr(path, '/');
+    char* directory;
+    Watched_File* file;
+    int watchDescriptor;
+
+    if (slash == NULL){
+        directory = malloc(2);
+        strcpy(directory, ".");
+    }
+    else {
+        directory = malloc(slash - path + 2);
+        memcpy(directory, path, slash - path + 1); /*keeps the slash, so "/file" watches "/"*/
+        directory[slash - path + 1] = '\0';
+    }
+    watchDescriptor = inotify_add_watch(inotify, directory, WATCH_EVENTS);
+    free(directory);
+    if (watchDescriptor < 0)
+        return 0;
+
+    if (list->fileCount >= list->filesSize){
+        list->filesSize += INITIAL_TABLE_SIZE;
+        list->files = realloc(list->files, list->filesSize * sizeof(Watched_File));
+    }
+    file = &list->files[list->fileCount++];
+    file->watchDescriptor = watchDescriptor;
+    file->name = malloc(strlen(slash == NULL ? path : slash + 1) + 1);
+    strcpy(file->name, slash == NULL ? path : slash + 1);
+    file->fileIndex = fileIndex;
+    file->isInclude = isInclude;
+    return 1;
+}
+
+
+/*Stops watching the files that the given file of the command line includes. The directories stay watched.*/
+static void removeIncludedFiles(Watch_List* list, int fileIndex){
+    int i, kept = 0;
+    for (i=0; i < list->fileCount; i++){
+        if (list->files[i].isInclude && list->files[i].fileIndex == fileIndex)
+            free(list->files[i].name);
+        else list->files[kept++] = list->files[i];
+    }
+    list->fileCount = kept;
+}
+
+
+/*Assembles the given file of the command line and watches the files its source included instead of the ones it
+  included before.*/
+static void assembleAndWatchIncludes(int inotify, Watch_List* list, char* fileName, int fileIndex, Assemble_Function assemble){
+    Include_Dependencies includedFiles = {NULL, 0, 0};
+    char* sourcePath;
+    int i;
+
+    assemble(fileName, stdout, &includedFiles);
+    fflush(stdout);
+
+    removeIncludedFiles(list, fileIndex);
+    for (i=0; i < includedFiles.count; i++){
+        sourcePath = malloc(strlen(includedFiles.files[i].fileName) + strlen(SOURCE_FILETYPE) + 1);
+        sprintf(sourcePath, "%s%s", includedFiles.files[i].fileName, SOURCE_FILETYPE);
+        if (!addWatchedFile(inotify, list, sourcePath, fileIndex, 1))
+            fprintf(stdout, "Error: Failed to watch %s for changes.\n", sourcePath);
+        free(sourcePath);
+    }
+    freeIncludeDependencies(&includedFiles);
+}
+
+
+/*Marks the given files that read the file an event is about as changed: 1 if their source changed, 2 if only a file
+  they include did.*/
+static void markChangedFiles(Watch_List* list, struct inotify_event* event, int* changed){
+    Watched_File* file;
+    int i;
+    if (event->len == 0)
+        return;
+    for (i=0; i < list->fileCount; i++){
+        file = &list->files[i];
+        if (file->watchDescriptor == event->wd && strcmp(file->name, event->name) == 0 && changed[file->fileIndex] != 1)
+            changed[file->fileIndex] = file->isInclude ? 2 : 1;
+    }
+}
+
+
+/*Receives the files of the command line (without the .as ending) and the function that assembles a file, assembles
+  the files and then assembles a file again every time its source or a file it includes changes. Files that change
+  together (in the same read of events) are assembled once each, in the order they were given. Returns only if the
+  files cannot be watched.*/
+int watchFiles(char** fileNames, int fileCount, Assemble_Function assemble){
+    Watch_List list = {NULL, 0, 0};
+    char* eventBuffer = malloc(EVENT_BUFFER_SIZE);
+    char* sourcePath;
+    int* changed = calloc(fileCount, sizeof(int));
+    struct inotify_event* event;
+    ssize_t length;
+    char* position;
+    int inotify = inotify_init();
+    int watchedSources;
+    int i;
+
+    for (i=0; i < fileCount && inotify >= 0; i++){
+        sourcePath = malloc(strlen(fileNames[i]) + strlen(SOURCE_FILETYPE) + 1);
+        sprintf(sourcePath, "%s%s", fileNames[i], SOURCE_FILETYPE);
+        if (!addWatchedFile(inotify, &list, sourcePath, i, 0))
+            fprintf(stdout, "Error: Failed to watch %s for changes.\n", sourcePath);
+        free(sourcePath);
+    }
+    if (inotify < 0 || list.fileCount == 0){
+        fprintf(stdout, "Error: Failed to start watching the files.\n");
+        free(eventBuffer);
+        free(changed);
+        return 0;
+    }
+    watchedSources = list.fileCount;
+    for (i=0; i < fileCount; i++)
+        assembleAndWatchIncludes(inotify, &list, fileNames[i], i, assemble);
+
+    fprintf(stdout, "\nWatching %d file/s for changes.\n", watchedSources);
+    fflush(stdout);
+    while ((length = read(inotify, eventBuffer, EVENT_BUFFER_SIZE)) > 0 || (length < 0 && errno == EINTR)){
+        for (position = eventBuffer; position < eventBuffer + length; position += sizeof(struct inotify_event) + event->len){
+            event = (struct inotify_event*)position;
+            markChangedFiles(&list, event, changed);
+        }
+        for (i=0; i < fileCount; i++){
+            if (!changed[i])
+                continue;
+            if (changed[i] == 1)
+                fprintf(stdout, "\n%s%s changed, assembling it again.\n", fileNames[i], SOURCE_FILETYPE);
+            else fprintf(stdout, "\nA file that %s%s includes changed, assembling it again.\n", fileNames[i], SOURCE_FILETYPE);
+            changed[i] = 0;
+            assembleAndWatchIncludes(inotify, &list, fileNames[i], i, assemble);
+        }
+    }
+
+    for (i=0; i < list.fileCount; i++)
+        free(list.files[i].name);
+    free(list.files);
+    free(eventBuffer);
+    free(changed);
+    close(inotify);
+    return 0;
+}